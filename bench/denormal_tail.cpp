@@ -0,0 +1,86 @@
+/*
+ * denormal_tail.cpp - Render cost through a decaying tail
+ *
+ * Loads a built dsp.so and plays a held 8-note chord for 1 s, then
+ * releases it into 120 s of silence, timing the host's render_block (the
+ * path with the FP scope of nusaw_denormal.h). Reports us per 128-frame
+ * block per 10 s window. Without denormal protection the cost climbs
+ * while filter, DC blocker and delay state decay through the denormal
+ * range; with it, it stays flat and falls once the tail is silent.
+ *
+ *   denormal_tail <dsp.so> [preset [key=value ...]]
+ *
+ * Preset 24 (dub delay, high feedback) by default. The governor and
+ * worker threads are off so the time is the render's alone.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "nsaw_host.h"
+
+#define SAMPLE_RATE 44100
+#define BLOCK_FRAMES 128
+#define WINDOW_SECONDS 10
+#define TAIL_SECONDS 120
+
+static double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <dsp.so> [preset [key=value ...]]\n", argv[0]);
+        return 2;
+    }
+    nsaw_host_t h;
+    if (nsaw_host_load(&h, argv[1], SAMPLE_RATE) != 0) return 1;
+
+    void *inst = h.api->create_instance(".", "{}");
+    h.api->set_param(inst, "preset", argc > 2 ? argv[2] : "24");
+    h.api->set_param(inst, "cpu_target", "0");
+    h.api->set_param(inst, "render_threads", "0");
+    for (int a = 3; a < argc; a++) {
+        char kv[128];
+        snprintf(kv, sizeof(kv), "%s", argv[a]);
+        char *eq = strchr(kv, '=');
+        if (!eq) continue;
+        *eq = '\0';
+        h.api->set_param(inst, kv, eq + 1);
+    }
+
+    static const uint8_t chord[] = { 36, 43, 48, 52, 55, 60, 64, 67 };
+    int16_t out[2 * BLOCK_FRAMES];
+    int blocks_per_second = SAMPLE_RATE / BLOCK_FRAMES;
+
+    for (size_t k = 0; k < sizeof(chord); k++) {
+        uint8_t msg[3] = { 0x90, chord[k], 110 };
+        h.api->on_midi(inst, msg, 3, 0);
+    }
+    for (int b = 0; b < blocks_per_second; b++)
+        h.api->render_block(inst, out, BLOCK_FRAMES);
+    for (size_t k = 0; k < sizeof(chord); k++) {
+        uint8_t msg[3] = { 0x80, chord[k], 0 };
+        h.api->on_midi(inst, msg, 3, 0);
+    }
+
+    printf("after release   us/block  nonzero samples\n");
+    int window = WINDOW_SECONDS * blocks_per_second;
+    for (int sec = 0; sec < TAIL_SECONDS; sec += WINDOW_SECONDS) {
+        long nonzero = 0;
+        double t0 = now();
+        for (int b = 0; b < window; b++) {
+            h.api->render_block(inst, out, BLOCK_FRAMES);
+            for (int i = 0; i < 2 * BLOCK_FRAMES; i++) nonzero += out[i] != 0;
+        }
+        double us = (now() - t0) / window * 1e6;
+        printf("  %3d-%3d s      %6.2f    %ld\n", sec, sec + WINDOW_SECONDS, us, nonzero);
+    }
+
+    h.api->destroy_instance(inst);
+    return 0;
+}
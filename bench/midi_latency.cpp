@@ -0,0 +1,123 @@
+/*
+ * midi_latency.cpp - Note-on latency and jitter, block start vs timed
+ *
+ * Loads a built dsp.so and plays single note-ons that arrive at random
+ * offsets within a 128-frame block. The host delivers an event before
+ * the next render call; latency is from arrival to the first nonzero
+ * output sample, in frames:
+ *
+ *   on_midi             applied at the start of the next call: latency
+ *                       depends on where in the block the event arrived
+ *   nsaw_on_midi_timed  queued at its arrival offset in the next call:
+ *                       constant one-block latency
+ *   timed, 2x rate      the same with the engine oversampled (render_rate
+ *                       1), which adds the decimator's delay
+ *
+ *   midi_latency <dsp.so>
+ *
+ * Builds without nsaw_on_midi_timed report the on_midi row only. Attack
+ * and release are 0 and the effects off, so the first sample is the
+ * note's.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "nsaw_host.h"
+
+#define SAMPLE_RATE 44100
+#define BLOCK_FRAMES 128
+#define NOTES 500
+#define SETTLE_BLOCKS 200       /* between notes: back to silence */
+#define MAX_BLOCKS 4            /* give up looking for the onset after this */
+
+typedef struct {
+    const char *name;
+    int timed;
+    const char *render_rate;
+} latency_mode_t;
+
+static const latency_mode_t g_modes[] = {
+    { "on_midi (block start)", 0, "0" },
+    { "nsaw_on_midi_timed", 1, "0" },
+    { "timed, 2x render rate", 1, "1" },
+};
+
+static void measure(nsaw_host_t *h, const latency_mode_t *mode) {
+    void *inst = h->api->create_instance(".", "{}");
+    static const char *params[][2] = {
+        { "attack", "0" }, { "release", "0" }, { "chorus_mix", "0" },
+        { "delay_mix", "0" }, { "cpu_target", "0" },
+    };
+    for (size_t i = 0; i < sizeof(params) / sizeof(params[0]); i++)
+        h->api->set_param(inst, params[i][0], params[i][1]);
+    h->api->set_param(inst, "render_rate", mode->render_rate);
+
+    int16_t out[2 * BLOCK_FRAMES];
+    double sum = 0.0, sum_sq = 0.0;
+    int min = -1, max = -1, missed = 0;
+    srand(1);
+    for (int n = 0; n < NOTES; n++) {
+        for (int b = 0; b < SETTLE_BLOCKS; b++)
+            h->api->render_block(inst, out, BLOCK_FRAMES);
+
+        /* Arrives `offset` frames into the block being played out, so
+         * BLOCK_FRAMES - offset frames before the next call starts */
+        int offset = rand() % BLOCK_FRAMES;
+        uint8_t on[3] = { 0x90, 60, 100 };
+        if (mode->timed)
+            h->on_midi_timed(inst, on, 3, 0, offset);
+        else
+            h->api->on_midi(inst, on, 3, 0);
+
+        int first = -1;
+        for (int b = 0; b < MAX_BLOCKS && first < 0; b++) {
+            h->api->render_block(inst, out, BLOCK_FRAMES);
+            for (int i = 0; i < BLOCK_FRAMES; i++) {
+                if (out[2 * i] || out[2 * i + 1]) {
+                    first = b * BLOCK_FRAMES + i;
+                    break;
+                }
+            }
+        }
+        uint8_t off[3] = { 0x80, 60, 0 };
+        h->api->on_midi(inst, off, 3, 0);
+        if (first < 0) {
+            missed++;
+            continue;
+        }
+
+        int latency = first + (BLOCK_FRAMES - offset);
+        sum += latency;
+        sum_sq += (double)latency * latency;
+        if (min < 0 || latency < min) min = latency;
+        if (latency > max) max = latency;
+    }
+    h->api->destroy_instance(inst);
+
+    int count = NOTES - missed;
+    double mean = count ? sum / count : 0.0;
+    double sd = count ? sqrt(fmax(sum_sq / count - mean * mean, 0.0)) : 0.0;
+    printf("  %-22s  mean %6.1f  min %4d  max %4d  stddev %5.1f", mode->name, mean, min, max,
+           sd);
+    if (missed) printf("  (%d silent)", missed);
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <dsp.so>\n", argv[0]);
+        return 2;
+    }
+    nsaw_host_t h;
+    if (nsaw_host_load(&h, argv[1], SAMPLE_RATE) != 0) return 1;
+
+    printf("%d note-ons at random offsets, %d-frame blocks, latency in frames\n", NOTES,
+           BLOCK_FRAMES);
+    for (size_t m = 0; m < sizeof(g_modes) / sizeof(g_modes[0]); m++) {
+        if (g_modes[m].timed && !h.on_midi_timed) continue;
+        measure(&h, &g_modes[m]);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * osc_block.cpp - Saw bank: per-sample kernels vs block kernels
+ *
+ * Times the two ways render_voice_osc can run the saw bank for one
+ * control block: the per-sample kernels of nusaw_osc_bank.h with the
+ * ramp tables advanced each sample (osc_tables_advance), and the block
+ * kernels of nusaw_osc_block.h specialized per saw count. Kernels only,
+ * no engine around them; float phase, 1x rate, every odd saw count.
+ *
+ * Prints ns per output sample for each and the largest end-phase
+ * difference between the two (0: they render the same bank).
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "nusaw_osc_block.h"
+
+#define FRAMES 32               /* control block */
+#define BLOCKS 20000
+#define TABLE 32                /* NSAW_MAX_OSC_VOICES padded to whole vectors */
+
+typedef struct {
+    float inc[TABLE] NSAW_ALIGNED, inc_step[TABLE] NSAW_ALIGNED;
+    float gain_l[TABLE] NSAW_ALIGNED, gain_l_step[TABLE] NSAW_ALIGNED;
+    float gain_r[TABLE] NSAW_ALIGNED, gain_r_step[TABLE] NSAW_ALIGNED;
+} ramps_t;
+
+/* Outside this file's reach so no output store can be optimized away */
+float g_out_l[FRAMES], g_out_r[FRAMES];
+
+static double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void init_bank(ramps_t *r, float *phase, int saws) {
+    for (int j = 0; j < TABLE; j++) {
+        r->inc[j] = j < saws ? 0.01f + 0.0003f * j : 0.0f;
+        r->gain_l[j] = r->gain_r[j] = j < saws ? 0.3f : 0.0f;
+        r->inc_step[j] = r->gain_l_step[j] = r->gain_r_step[j] = 0.0f;
+    }
+    for (int j = 0; j < NSAW_MAX_OSC_VOICES; j++) phase[j] = j * 0.037f;
+}
+
+/* render_voice_osc's per-sample path: step the ramps, tick the bank */
+static double time_per_sample(int kind, int saws, float *phase) {
+    ramps_t r;
+    init_bank(&r, phase, saws);
+    float inc[TABLE] NSAW_ALIGNED, gain_l[TABLE] NSAW_ALIGNED, gain_r[TABLE] NSAW_ALIGNED;
+
+    double t0 = now();
+    for (int b = 0; b < BLOCKS; b++) {
+        for (int j = 0; j < TABLE; j++) {
+            inc[j] = r.inc[j];
+            gain_l[j] = r.gain_l[j];
+            gain_r[j] = r.gain_r[j];
+        }
+        for (int f = 0; f < FRAMES; f++) {
+            for (int j = 0; j < TABLE; j += OB_LANES) {
+                ob_store(inc + j, ob_add(ob_load(inc + j), ob_load(r.inc_step + j)));
+                ob_store(gain_l + j, ob_add(ob_load(gain_l + j), ob_load(r.gain_l_step + j)));
+                ob_store(gain_r + j, ob_add(ob_load(gain_r + j), ob_load(r.gain_r_step + j)));
+            }
+            if (kind == NSAW_OSC_BLOCK_POLYBLEP)
+                nsaw_osc_bank_tick(phase, inc, gain_l, gain_r, saws,
+                                   &g_out_l[f], &g_out_r[f]);
+            else
+                nsaw_osc_bank_tick_naive(phase, inc, gain_l, gain_r, saws,
+                                         &g_out_l[f], &g_out_r[f]);
+        }
+    }
+    return (now() - t0) / ((double)BLOCKS * FRAMES) * 1e9;
+}
+
+static double time_block(nsaw_osc_block_fn fn, int saws, float *phase) {
+    ramps_t r;
+    init_bank(&r, phase, saws);
+    nsaw_osc_block_args_t a = { phase, NULL, r.inc, r.inc_step, NULL, NULL,
+                                r.gain_l, r.gain_l_step, r.gain_r, r.gain_r_step };
+
+    double t0 = now();
+    for (int b = 0; b < BLOCKS; b++)
+        fn(&a, FRAMES, 1, g_out_l, g_out_r, 1);
+    return (now() - t0) / ((double)BLOCKS * FRAMES) * 1e9;
+}
+
+int main(void) {
+    static const struct { int kind; const char *name; } kinds[] = {
+        { NSAW_OSC_BLOCK_NAIVE, "naive" },
+        { NSAW_OSC_BLOCK_POLYBLEP, "PolyBLEP" },
+    };
+
+    printf("%d-frame blocks, %d lanes, ns per sample\n", FRAMES, OB_LANES);
+    for (int k = 0; k < 2; k++) {
+        printf("%s\n", kinds[k].name);
+        for (int saws = 1; saws <= NSAW_MAX_OSC_VOICES; saws += 2) {
+            float phase_a[NSAW_MAX_OSC_VOICES], phase_b[NSAW_MAX_OSC_VOICES];
+            double per_sample = time_per_sample(kinds[k].kind, saws, phase_a);
+            nsaw_osc_block_fn fn = nsaw_osc_block_kernel(kinds[k].kind, saws);
+            if (!fn) {
+                printf("  saws %2d  per-sample %6.1f  (no block kernel)\n", saws, per_sample);
+                continue;
+            }
+            double block = time_block(fn, saws, phase_b);
+
+            float max_diff = 0.0f;
+            for (int j = 0; j < saws; j++)
+                max_diff = fmaxf(max_diff, fabsf(phase_a[j] - phase_b[j]));
+            printf("  saws %2d  per-sample %6.1f  block %6.1f  x%.2f  (end phase diff %g)\n",
+                   saws, per_sample, block, per_sample / block, max_diff);
+        }
+    }
+    return 0;
+}
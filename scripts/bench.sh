@@ -0,0 +1,80 @@
+#!/usr/bin/env bash
+# Build and run the NuSaw benchmarks (bench/) on this machine
+#
+# Uses the native compiler (CXX, default g++), like scripts/test.sh.
+# BENCH_CFLAGS is passed through, e.g. BENCH_CFLAGS=-mavx2 to time the
+# AVX2 backend or -DNSAW_SIMD_FORCE_SCALAR for the scalar one. Output
+# goes to build/bench/. Timings are wall clock: run on an idle machine.
+#
+#   scripts/bench.sh            all benchmarks
+#   scripts/bench.sh osc_block  just the ones named (osc_block,
+#                               denormal_tail, midi_latency)
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+REPO_ROOT="$(dirname "$SCRIPT_DIR")"
+CXX="${CXX:-g++}"
+
+cd "$REPO_ROOT"
+OUT=build/bench
+mkdir -p "$OUT"
+
+CFLAGS=(-O3 -std=c++14 -ffp-contract=off $BENCH_CFLAGS)
+SELECTED=("$@")
+
+selected() {
+    [ ${#SELECTED[@]} -eq 0 ] && return 0
+    for name in "${SELECTED[@]}"; do
+        [ "$name" = "$1" ] && return 0
+    done
+    return 1
+}
+
+# --- Saw bank block kernels -------------------------------------------------
+# Per-sample bank kernels vs the per-count block kernels, kernels only.
+if selected osc_block; then
+    echo "=== osc_block ==="
+    $CXX "${CFLAGS[@]}" bench/osc_block.cpp src/dsp/nusaw_osc_tables.cpp \
+        -o "$OUT/osc_block" -Isrc/dsp -lm
+    "$OUT/osc_block"
+    echo ""
+fi
+
+# --- Plugin benchmarks ------------------------------------------------------
+# The rest load dsp.so the way the host does (tests/nsaw_host.h).
+DSP_SRCS=(
+    src/dsp/nusaw_plugin.cpp
+    src/dsp/nusaw_engine.cpp
+    src/dsp/nusaw_kernels.cpp
+    src/dsp/nusaw_osc_tables.cpp
+    src/dsp/nusaw_worker_pool.cpp
+)
+DSP_SO="$OUT/dsp.so"
+DSP_BUILT=0
+build_dsp() {
+    [ "$DSP_BUILT" -eq 1 ] && return 0
+    echo "  building dsp.so"
+    $CXX "${CFLAGS[@]}" -shared -fPIC "${DSP_SRCS[@]}" -o "$DSP_SO" -Isrc/dsp -lm -lpthread
+    DSP_BUILT=1
+}
+HOST_CFLAGS=(-O2 -std=c++14 -Itests)
+
+# --- Denormal tails ---------------------------------------------------------
+# Render cost per 10 s while a released chord's delay tail decays to zero.
+if selected denormal_tail; then
+    echo "=== denormal_tail ==="
+    build_dsp
+    $CXX "${HOST_CFLAGS[@]}" bench/denormal_tail.cpp -o "$OUT/denormal_tail" -ldl
+    "$OUT/denormal_tail" "$DSP_SO"
+    echo ""
+fi
+
+# --- MIDI latency -----------------------------------------------------------
+# Note-on latency and jitter with on_midi vs sample-accurate timed events.
+if selected midi_latency; then
+    echo "=== midi_latency ==="
+    build_dsp
+    $CXX "${HOST_CFLAGS[@]}" bench/midi_latency.cpp -o "$OUT/midi_latency" -ldl -lm
+    "$OUT/midi_latency" "$DSP_SO"
+    echo ""
+fi
@@ -48,13 +48,52 @@ mkdir -p build
 mkdir -p dist/nusaw
 
 # Compile DSP plugin
+# EXTRA_CFLAGS is passed through, e.g. EXTRA_CFLAGS=-DNSAW_USE_LIBM for a
+# reference render using libm instead of the fast math kernels, or
+# -DNSAW_SIMD_FORCE_SCALAR to run the vector kernels on the scalar backend.
+#
+# The render kernels (nusaw_kernels.cpp) are also compiled once per extra
+# ISA level of the target; the plugin picks the best one the CPU supports
+# at load time. CROSS_PREFIX=x86_64-linux-gnu- builds a desktop dsp.so
+# with the x86 levels. Those build without FP contraction so that every
+# level renders the baseline's samples (to 1 LSB from vector width).
+case "$(${CROSS_PREFIX}g++ -dumpmachine)" in
+    aarch64*)
+        KERNEL_ISAS=("armv82|-march=armv8.2-a+fp16+dotprod")
+        ;;
+    x86_64*)
+        KERNEL_ISAS=("avx2|-mavx2 -ffp-contract=off"
+                     "avx512|-mavx512f -mavx512vl -mavx2 -ffp-contract=off")
+        ;;
+    *)
+        KERNEL_ISAS=()
+        ;;
+esac
+
 echo "Compiling DSP plugin..."
-${CROSS_PREFIX}g++ -g -O3 -shared -fPIC -std=c++14 \
+KERNEL_OBJS=()
+for entry in "${KERNEL_ISAS[@]}"; do
+    isa="${entry%%|*}"
+    flags="${entry#*|}"
+    echo "  kernels: $isa"
+    ${CROSS_PREFIX}g++ -g -O3 -fPIC -std=c++14 ${EXTRA_CFLAGS} $flags \
+        -DNSAW_KERNELS_ISA=$isa \
+        -c src/dsp/nusaw_kernels.cpp \
+        -o build/nusaw_kernels_$isa.o \
+        -Isrc/dsp
+    KERNEL_OBJS+=("build/nusaw_kernels_$isa.o")
+done
+
+${CROSS_PREFIX}g++ -g -O3 -shared -fPIC -std=c++14 ${EXTRA_CFLAGS} \
     src/dsp/nusaw_plugin.cpp \
     src/dsp/nusaw_engine.cpp \
+    src/dsp/nusaw_kernels.cpp \
+    src/dsp/nusaw_osc_tables.cpp \
+    src/dsp/nusaw_worker_pool.cpp \
+    "${KERNEL_OBJS[@]}" \
     -o build/dsp.so \
     -Isrc/dsp \
-    -lm
+    -lm -lpthread
 
 # Copy files to dist (use cat to avoid ExtFS deallocation issues with Docker)
 echo "Packaging..."
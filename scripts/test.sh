@@ -0,0 +1,103 @@
+#!/usr/bin/env bash
+# Build and run the NuSaw test programs (tests/) on this machine
+#
+# Uses the native compiler (CXX, default g++): the tests run what they
+# build, so this is not a cross build. Output goes to build/tests/.
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+REPO_ROOT="$(dirname "$SCRIPT_DIR")"
+CXX="${CXX:-g++}"
+
+cd "$REPO_ROOT"
+OUT=build/tests
+mkdir -p "$OUT"
+
+DSP_SRCS=(
+    src/dsp/nusaw_plugin.cpp
+    src/dsp/nusaw_engine.cpp
+    src/dsp/nusaw_kernels.cpp
+    src/dsp/nusaw_osc_tables.cpp
+    src/dsp/nusaw_worker_pool.cpp
+)
+
+FAILED=0
+run() {
+    if "$@"; then :; else FAILED=1; fi
+}
+
+# --- SIMD backend agreement -------------------------------------------------
+# dsp.so once per backend of nusaw_simd.h (base kernels only, no per-ISA
+# variants, no FP contraction), rendering the same MIDI. A vector backend
+# must match the scalar backend of the same lane width exactly; the 4- and
+# 8-lane layouts differ only by summation order.
+WIDTH_TOLERANCE=1e-5    # full scale 1.0; ~1/3 of an int16 step
+echo "=== SIMD backend agreement ==="
+
+case "$($CXX -dumpmachine)" in
+    aarch64*)
+        BACKENDS=("scalar|-DNSAW_SIMD_FORCE_SCALAR"
+                  "neon|"
+                  "scalar8|-DNSAW_SIMD_FORCE_SCALAR -DNSAW_SIMD_WIDTH=8"
+                  "neon8|-DNSAW_SIMD_WIDTH=8")
+        PAIRS=("scalar neon 0" "scalar8 neon8 0")
+        ;;
+    x86_64*)
+        BACKENDS=("scalar|-DNSAW_SIMD_FORCE_SCALAR"
+                  "sse2|"
+                  "scalar8|-DNSAW_SIMD_FORCE_SCALAR -DNSAW_SIMD_WIDTH=8"
+                  "sse2x8|-DNSAW_SIMD_WIDTH=8"
+                  "avx2|-mavx2")
+        PAIRS=("scalar sse2 0" "scalar8 sse2x8 0" "scalar8 avx2 0")
+        ;;
+    *)
+        BACKENDS=("scalar|-DNSAW_SIMD_FORCE_SCALAR"
+                  "scalar8|-DNSAW_SIMD_FORCE_SCALAR -DNSAW_SIMD_WIDTH=8")
+        PAIRS=()
+        ;;
+esac
+PAIRS+=("scalar scalar8 $WIDTH_TOLERANCE")
+
+$CXX -O2 -std=c++14 tests/backend_agreement.cpp -o "$OUT/backend_agreement" -Itests -ldl
+
+for entry in "${BACKENDS[@]}"; do
+    name="${entry%%|*}"
+    flags="${entry#*|}"
+    echo "  building $name"
+    $CXX -O3 -shared -fPIC -std=c++14 -ffp-contract=off $flags \
+        "${DSP_SRCS[@]}" -o "$OUT/dsp_$name.so" -Isrc/dsp -lm -lpthread
+    "$OUT/backend_agreement" render "$OUT/dsp_$name.so" "$OUT/render_$name.raw"
+done
+
+for pair in "${PAIRS[@]}"; do
+    read -r a b tol <<< "$pair"
+    echo "  $a vs $b"
+    run "$OUT/backend_agreement" compare "$OUT/render_$a.raw" "$OUT/render_$b.raw" "$tol"
+done
+
+# --- Analog drift -----------------------------------------------------------
+# Depth and low-pass corner of the per-oscillator pitch drift at several
+# sample rates and control block sizes, whole or split across render calls,
+# against DRIFT_HZ and DRIFT_AMOUNT.
+ENGINE_SRCS=("${DSP_SRCS[@]:1}")    # no plugin wrapper
+echo ""
+echo "=== Analog drift ==="
+$CXX -O2 -std=c++14 tests/drift_check.cpp "${ENGINE_SRCS[@]}" \
+    -o "$OUT/drift_check" -Isrc/dsp -lm -lpthread
+run "$OUT/drift_check"
+
+# --- Sub oscillator amplitude -----------------------------------------------
+# Minutes of the quadrature sub at extreme increments: the phasor length
+# error must stay within one control block's worth of rounding.
+echo ""
+echo "=== Sub oscillator amplitude ==="
+$CXX -O2 -std=c++14 tests/sub_rotation.cpp "${ENGINE_SRCS[@]}" \
+    -o "$OUT/sub_rotation" -Isrc/dsp -lm -lpthread
+run "$OUT/sub_rotation"
+
+echo ""
+if [ "$FAILED" -ne 0 ]; then
+    echo "=== Tests FAILED ==="
+    exit 1
+fi
+echo "=== All tests passed ==="
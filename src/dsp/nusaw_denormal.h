@@ -0,0 +1,85 @@
+/*
+ * nusaw_denormal.h - Denormal protection
+ *
+ * Release tails, filter and DC-blocker state and the delay's feedback
+ * loop all decay exponentially toward zero and, left alone, end up in the
+ * denormal range, where x86 cores (and some ARM FPU configurations) take
+ * a slow path on every operation. Two layers keep them out:
+ *
+ *   FP scope   flush-to-zero (and denormals-are-zero) in the FPU control
+ *              register for the length of a render call, restored after
+ *              so the host thread's mode is untouched. Reading and
+ *              writing the register is a few cycles, no syscall.
+ *   guards     recursive state below NSAW_DENORMAL_FLOOR is flushed to
+ *              exact zero (per control block, or per sample where state
+ *              is written into a buffer). This is what protects builds
+ *              or threads without the FP scope.
+ */
+
+#ifndef NUSAW_DENORMAL_H
+#define NUSAW_DENORMAL_H
+
+#include <math.h>
+#include <stdint.h>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+/* Far below int16 resolution (~-300 dBFS), far above FLT_MIN */
+#define NSAW_DENORMAL_FLOOR 1e-15f
+
+static inline float nsaw_flush_denormal(float x) {
+    return fabsf(x) < NSAW_DENORMAL_FLOOR ? 0.0f : x;
+}
+
+/* Saved FPU control register */
+typedef struct {
+    uint64_t saved;
+} nsaw_fp_scope_t;
+
+#if defined(__SSE__)
+#define NSAW_FP_FLUSH_BITS 0x8040u      /* MXCSR FTZ | DAZ */
+static inline uint64_t nsaw_fp_control_get(void) { return _mm_getcsr(); }
+static inline void nsaw_fp_control_set(uint64_t r) { _mm_setcsr((unsigned int)r); }
+#elif defined(__aarch64__)
+#define NSAW_FP_FLUSH_BITS (1u << 24)   /* FPCR FZ (inputs and results) */
+static inline uint64_t nsaw_fp_control_get(void) {
+    uint64_t r;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(r));
+    return r;
+}
+static inline void nsaw_fp_control_set(uint64_t r) {
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(r));
+}
+#elif defined(__arm__) && defined(__ARM_FP)
+#define NSAW_FP_FLUSH_BITS (1u << 24)   /* FPSCR FZ */
+static inline uint64_t nsaw_fp_control_get(void) {
+    uint32_t r;
+    __asm__ __volatile__("vmrs %0, fpscr" : "=r"(r));
+    return r;
+}
+static inline void nsaw_fp_control_set(uint64_t r) {
+    __asm__ __volatile__("vmsr fpscr, %0" : : "r"((uint32_t)r));
+}
+#else
+#define NSAW_FP_FLUSH_BITS 0u           /* no control register: guards only */
+static inline uint64_t nsaw_fp_control_get(void) { return 0; }
+static inline void nsaw_fp_control_set(uint64_t r) { (void)r; }
+#endif
+
+/* Enter flush-to-zero mode; the register is only written if the mode
+ * was off (writes can serialize the pipeline) */
+static inline void nsaw_fp_scope_enter(nsaw_fp_scope_t *scope) {
+    scope->saved = nsaw_fp_control_get();
+    if ((scope->saved & NSAW_FP_FLUSH_BITS) != NSAW_FP_FLUSH_BITS)
+        nsaw_fp_control_set(scope->saved | NSAW_FP_FLUSH_BITS);
+}
+
+/* Restore the mode saved by nsaw_fp_scope_enter() */
+static inline void nsaw_fp_scope_exit(const nsaw_fp_scope_t *scope) {
+    if ((scope->saved & NSAW_FP_FLUSH_BITS) != NSAW_FP_FLUSH_BITS)
+        nsaw_fp_control_set(scope->saved);
+}
+
+#endif /* NUSAW_DENORMAL_H */
@@ -2,7 +2,11 @@
  * nusaw_engine.cpp - NuSaw polyphonic synthesizer engine
  *
  * Detuned multi-voice sawtooth (7 voices per note) with:
- *   - PolyBLEP anti-aliased saw generation
+ *   - Anti-aliased saw generation (SIMD oscillator bank) with selectable
+ *     tiers: naive, DPW, PolyBLEP, minBLEP, or auto by note frequency,
+ *     or reads from mip-mapped band-limited wavetables
+ *   - Optional 2x/4x voice path (oscillators, HPF, SVF) with a polyphase
+ *     halfband decimator, latched per note for resonant, bright patches
  *   - Exponential detune spacing (1:3:6 ratio) for dense chorused core
  *   - Piecewise-linear detune curve for fine resolution at low values
  *   - Center-anchored mix law (center ~1.5x sides at full spread)
@@ -11,18 +15,36 @@
  *   - Random phase initialization on each note-on
  *   - Analog pitch drift (slow random walk per oscillator)
  *   - Stereo panning of detuned pairs (constant-power pan law)
- *   - Sine sub oscillator with configurable octave offset (-2, -1, 0)
+ *   - Sine sub oscillator (renormalized quadrature rotation) with
+ *     configurable octave offset (-2, -1, 0)
  *   - 1-pole DC-blocking HPF after oscillator mix (stereo)
  *   - TPT/SVF resonant lowpass filter (stereo)
  *   - ADSR amp and filter envelopes
- *   - 8-voice polyphony with oldest-note stealing
- *   - One-pole parameter smoothing for detune/spread
+ *   - Configurable polyphony (1-32, default 8) from a preallocated,
+ *     cache-aligned voice pool, with oldest-note stealing
+ *   - Optional multi-core rendering: voices split into jobs on a
+ *     real-time worker pool, mixed back in a fixed order
+ *   - Silent-voice culling (held sustain-0 voices skip all DSP)
+ *   - Per-voice unison level of detail: super-Nyquist, coincident and
+ *     quiet-tail detune pairs are faded out with gain compensation
+ *   - CPU-governor degradation levels (thinner quiet voices, cheaper
+ *     tiers, saw and polyphony caps) instead of missed deadlines
+ *   - Voice-lane SIMD post stage: envelopes, HPF and SVF of all
+ *     output-rate voices run one voice per vector lane
+ *   - Engine-wide control-rate stage with per-sample linear ramps
  */
 
 #include "nusaw_engine.h"
+#include "nusaw_kernels.h"
+#include "nusaw_fastmath.h"
 #include <math.h>
 #include <string.h>
 
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -35,13 +57,6 @@
  * This is applied to the outermost pair; inner pairs are closer per spacing law */
 #define DETUNE_K_MAX 0.10f
 
-/* DC-blocking HPF cutoff ~20Hz: R = 1 - 2*pi*fc/fs */
-#define HPF_R 0.99715f  /* 1 - 2*pi*20/44100 */
-
-/* Parameter smoothing coefficient (~5ms at 44100Hz)
- * coeff = 1 - exp(-1/(0.005 * 44100)) ~ 0.00452 */
-#define SMOOTH_COEFF 0.00452f
-
 /* Side voice gain scaling: at spread=1.0, each side voice is at 0.667
  * so the center (1.0) is ~1.5x any individual side voice */
 #define SIDE_GAIN_SCALE 0.667f
@@ -50,11 +65,8 @@
  * Ensures detuned voices never completely vanish */
 #define SIDE_GAIN_FLOOR 0.015f
 
-/* Analog pitch drift: slow random walk per oscillator
- * DRIFT_AMOUNT ~0.35 cents (0.02% of frequency)
- * DRIFT_COEFF for ~8Hz lowpass: 2*pi*8/44100 ~ 0.00114 */
-#define DRIFT_AMOUNT 0.0002f
-#define DRIFT_COEFF  0.00114f
+/* DC-blocking HPF corner: pole 1 - 2*pi*HPF_HZ/sample_rate */
+#define HPF_HZ  20.0f
 
 /* Detune and pan coefficients are now computed dynamically in
  * nsaw_engine_update_osc_config() and stored in the engine struct.
@@ -64,7 +76,7 @@
  * Helpers
  * ===================================================================== */
 
-/* xorshift32 PRNG -- fast, good enough for phase randomization and drift */
+/* xorshift32 PRNG -- fast, good enough for phase randomization */
 static inline uint32_t xorshift32(uint32_t *state) {
     uint32_t x = *state;
     x ^= x << 13;
@@ -90,18 +102,6 @@ static inline float note_to_freq(int note) {
     return 440.0f * powf(2.0f, (note - 69) / 12.0f);
 }
 
-/* PolyBLEP residual for anti-aliased sawtooth */
-static inline float polyblep(float t, float dt) {
-    if (t < dt) {
-        t /= dt;
-        return t + t - t * t - 1.0f;
-    } else if (t > 1.0f - dt) {
-        t = (t - 1.0f) / dt;
-        return t * t + t + t + 1.0f;
-    }
-    return 0.0f;
-}
-
 /* Piecewise-linear detune curve: maps [0,1] -> [0,1]
  * Three segments for musical response:
  *   [0.0, 0.1] -> [0.0, 0.02]   gentle -- subtle thickening
@@ -159,6 +159,10 @@ void nsaw_engine_update_osc_config(nsaw_engine_t *engine, int num_oscs) {
         engine->pan_l[2*k] = cosf(theta_neg);
         engine->pan_r[2*k] = sinf(theta_neg);
     }
+
+    /* Newly enabled oscillators have no tier state; re-prime on next render */
+    for (int i = 0; i < NSAW_MAX_VOICES; i++)
+        engine->voices[i].aa_tier = -1;
 }
 
 /* =====================================================================
@@ -167,8 +171,9 @@ void nsaw_engine_update_osc_config(nsaw_engine_t *engine, int num_oscs) {
 
 void nsaw_engine_init(nsaw_engine_t *engine) {
     memset(engine, 0, sizeof(nsaw_engine_t));
-    engine->sample_rate = NSAW_SAMPLE_RATE;
+    nsaw_engine_set_sample_rate(engine, NSAW_SAMPLE_RATE);
     engine->voice_counter = 0;
+    engine->num_voices = NSAW_DEFAULT_VOICES;
 
     /* Seed PRNG (non-zero) */
     engine->rng_state = 0xDEADBEEF;
@@ -194,14 +199,24 @@ void nsaw_engine_init(nsaw_engine_t *engine) {
     engine->sub_octave = -1;
     engine->octave_transpose = 0;
     engine->current_bend = 0.0f;
+    engine->osc_kernel = NSAW_OSC_KERNEL_BLOCK;
+    engine->osc_quality = NSAW_OSC_QUALITY_AUTO;
+    engine->osc_mode = NSAW_OSC_MODE_ANALYTIC;
+    engine->oversample = NSAW_OVERSAMPLE_AUTO_2X;
+    engine->unison_lod = 1;
+    engine->phase_mode = NSAW_PHASE_FIXED;
+    engine->fast_paths = 1;
+    engine->kernels = &nsaw_kernels_base;
+
+    /* Shared oscillator tables (built once per process) */
+    nsaw_osc_tables_init();
 
     /* Initialize oscillator configuration */
     nsaw_engine_update_osc_config(engine, NSAW_DEFAULT_OSC_VOICES);
 
-    /* Initialize smoothed params to match targets */
-    engine->smooth_detune = engine->detune;
-    engine->smooth_spread = engine->spread;
-    engine->smooth_cutoff = engine->cutoff;
+    /* Control-rate stage (first render snaps to current params) */
+    nsaw_engine_set_control_block(engine, NSAW_DEFAULT_CONTROL_BLOCK);
+    engine->ctrl_valid = 0;
 
     for (int i = 0; i < NSAW_MAX_VOICES; i++) {
         engine->voices[i].active = 0;
@@ -215,16 +230,31 @@ void nsaw_engine_init(nsaw_engine_t *engine) {
  * ===================================================================== */
 
 static int find_free_voice(nsaw_engine_t *engine) {
+    /* Under CPU pressure new notes share the lower half of the voices;
+     * voices above keep sounding until they finish */
+    int limit = engine->num_voices;
+    if (engine->degrade >= NSAW_DEGRADE_CAP_VOICES) limit = (limit + 1) / 2;
+
     /* First: find an inactive voice */
-    for (int i = 0; i < NSAW_MAX_VOICES; i++) {
+    for (int i = 0; i < limit; i++) {
         if (!engine->voices[i].active && engine->voices[i].amp_env.stage == NSAW_ENV_OFF) {
             return i;
         }
     }
-    /* Second: find a releasing voice (steal the oldest) */
+    /* Second: a held voice that has decayed to silence (steal the oldest) */
     int oldest_idx = -1;
     uint32_t oldest_age = 0xFFFFFFFF;
-    for (int i = 0; i < NSAW_MAX_VOICES; i++) {
+    for (int i = 0; i < limit; i++) {
+        if (engine->voices[i].culled && engine->voices[i].age < oldest_age) {
+            oldest_age = engine->voices[i].age;
+            oldest_idx = i;
+        }
+    }
+    if (oldest_idx >= 0) return oldest_idx;
+
+    /* Third: find a releasing voice (steal the oldest) */
+    oldest_age = 0xFFFFFFFF;
+    for (int i = 0; i < limit; i++) {
         if (engine->voices[i].amp_env.stage == NSAW_ENV_RELEASE && engine->voices[i].age < oldest_age) {
             oldest_age = engine->voices[i].age;
             oldest_idx = i;
@@ -234,7 +264,7 @@ static int find_free_voice(nsaw_engine_t *engine) {
 
     /* Last resort: steal the oldest active voice */
     oldest_age = 0xFFFFFFFF;
-    for (int i = 0; i < NSAW_MAX_VOICES; i++) {
+    for (int i = 0; i < limit; i++) {
         if (engine->voices[i].age < oldest_age) {
             oldest_age = engine->voices[i].age;
             oldest_idx = i;
@@ -247,6 +277,21 @@ static int find_free_voice(nsaw_engine_t *engine) {
  * MIDI handlers
  * ===================================================================== */
 
+/* Oversampling factor for a new note: only resonant patches whose cutoff
+ * (with the full filter envelope) reaches the top octaves, where the SVF
+ * rings near Nyquist and amplifies saw aliasing */
+static int select_oversample(const nsaw_engine_t *engine) {
+    if (engine->oversample == NSAW_OVERSAMPLE_OFF) return 1;
+    if (engine->degrade >= NSAW_DEGRADE_CHEAP_TIERS) return 1;
+    if (engine->resonance < NSAW_OS_RESONANCE_THRESHOLD) return 1;
+
+    float peak_hz = 20.0f * nsaw_exp2f(engine->cutoff * NSAW_LOG2_1000 + engine->f_amount * 8.0f);
+    if (peak_hz * ((float)NSAW_SAMPLE_RATE / engine->sample_rate) < NSAW_OS_CUTOFF_THRESHOLD_HZ)
+        return 1;
+
+    return (engine->oversample == NSAW_OVERSAMPLE_AUTO_4X) ? 4 : 2;
+}
+
 void nsaw_engine_note_on(nsaw_engine_t *engine, int note, float velocity) {
     int vi = find_free_voice(engine);
     nsaw_voice_t *v = &engine->voices[vi];
@@ -258,13 +303,31 @@ void nsaw_engine_note_on(nsaw_engine_t *engine, int note, float velocity) {
     v->age = engine->voice_counter++;
 
     /* Random phase initialization and zero drift state */
-    for (int j = 0; j < engine->num_oscs; j++) {
-        v->phase[j] = rand_float(&engine->rng_state);
+    for (int j = 0; j < NSAW_MAX_OSC_VOICES; j++) {
+        if (j < engine->num_oscs) v->phase[j] = rand_float(&engine->rng_state);
         v->drift[j] = 0.0f;
     }
 
-    /* Sub oscillator starts at zero for clean attack */
-    v->sub_phase = 0.0f;
+    /* Fresh drift noise streams for this note */
+    v->drift_key = xorshift32(&engine->rng_state);
+    v->drift_counter = 0;
+
+    /* Anti-aliasing tier and unison LOD are (re)selected on the first render */
+    v->aa_tier = -1;
+    v->saws = -1;
+    v->phase_fixed = 0;     /* phases above are float */
+    v->culled = 0;
+
+    /* Oversampling factor for this note, fresh decimator state */
+    v->os_factor = select_oversample(engine);
+    for (int s = 0; s < 2; s++) {
+        nsaw_halfband_reset(&v->dec_l[s]);
+        nsaw_halfband_reset(&v->dec_r[s]);
+    }
+
+    /* Sub oscillator starts at phase 0 (sine = 0) for clean attack */
+    v->sub_re = 1.0f;
+    v->sub_im = 0.0f;
 
     /* Reset DC-blocking HPF state (stereo) */
     v->hpf_x_prev_l = 0.0f;
@@ -284,7 +347,7 @@ void nsaw_engine_note_on(nsaw_engine_t *engine, int note, float velocity) {
 }
 
 void nsaw_engine_note_off(nsaw_engine_t *engine, int note) {
-    for (int i = 0; i < NSAW_MAX_VOICES; i++) {
+    for (int i = 0; i < engine->num_voices; i++) {
         nsaw_voice_t *v = &engine->voices[i];
         if (v->active && v->note == note && v->amp_env.stage != NSAW_ENV_RELEASE) {
             v->active = 0;
@@ -294,12 +357,30 @@ void nsaw_engine_note_off(nsaw_engine_t *engine, int note) {
     }
 }
 
+void nsaw_engine_set_polyphony(nsaw_engine_t *engine, int voices) {
+    if (voices < 1) voices = 1;
+    if (voices > NSAW_MAX_VOICES) voices = NSAW_MAX_VOICES;
+
+    /* Voices past the limit are no longer rendered; stop them cleanly so
+     * they restart from rest if the limit is raised again */
+    for (int i = voices; i < engine->num_voices; i++) {
+        nsaw_voice_t *v = &engine->voices[i];
+        v->active = 0;
+        v->amp_env.stage = NSAW_ENV_OFF;
+        v->amp_env.level = 0.0f;
+        v->filt_env.stage = NSAW_ENV_OFF;
+        v->filt_env.level = 0.0f;
+        v->culled = 0;
+    }
+    engine->num_voices = voices;
+}
+
 void nsaw_engine_pitch_bend(nsaw_engine_t *engine, float bend) {
     engine->current_bend = bend;
 }
 
 void nsaw_engine_all_notes_off(nsaw_engine_t *engine) {
-    for (int i = 0; i < NSAW_MAX_VOICES; i++) {
+    for (int i = 0; i < engine->num_voices; i++) {
         nsaw_voice_t *v = &engine->voices[i];
         v->active = 0;
         v->amp_env.stage = NSAW_ENV_OFF;
@@ -318,230 +399,342 @@ void nsaw_engine_all_notes_off(nsaw_engine_t *engine) {
 }
 
 /* =====================================================================
- * Envelope processing (per sample)
+ * Control-rate stage
  * ===================================================================== */
 
-static inline void process_envelope(nsaw_envelope_t *env,
-                                     float attack_rate, float decay_coeff,
-                                     float sustain_level, float release_coeff) {
-    switch (env->stage) {
-        case NSAW_ENV_ATTACK:
-            env->level += attack_rate;
-            if (env->level >= 1.0f) {
-                env->level = 1.0f;
-                env->stage = NSAW_ENV_DECAY;
-            }
-            break;
-        case NSAW_ENV_DECAY:
-            env->level = sustain_level + (env->level - sustain_level) * decay_coeff;
-            if (env->level <= sustain_level + 0.0001f) {
-                env->level = sustain_level;
-                env->stage = NSAW_ENV_SUSTAIN;
-            }
-            break;
-        case NSAW_ENV_SUSTAIN:
-            env->level = sustain_level;
-            break;
-        case NSAW_ENV_RELEASE:
-            env->level *= release_coeff;
-            if (env->level < 0.0001f) {
-                env->level = 0.0f;
-                env->stage = NSAW_ENV_OFF;
-            }
-            break;
-        case NSAW_ENV_OFF:
-        default:
-            env->level = 0.0f;
-            break;
-    }
+/* Derive the voice-independent control values from the current engine
+ * parameters. Called once per control block for the whole engine; the
+ * per-sample loop ramps linearly between successive results. */
+static void compute_control(const nsaw_engine_t *engine, nsaw_control_t *c) {
+    /* Cutoff: exponential mapping 20Hz to 20kHz (the parameter's range;
+     * the SVF clamps it again at the rate it runs at, svf_max_cutoff()) */
+    c->cutoff_hz = 20.0f * nsaw_exp2f(engine->cutoff * NSAW_LOG2_1000);
+    if (c->cutoff_hz > 20000.0f) c->cutoff_hz = 20000.0f;
+
+    /* Resonance: Q from 0.5 to 20, stored as SVF damping k = 1/Q */
+    c->k = 1.0f / (0.5f + engine->resonance * 19.5f);
+
+    /* Filter envelope amount in octaves (0 to 8) */
+    c->f_env_octaves = engine->f_amount * 8.0f;
+
+    /* --- Detune scaling ---
+     * Piecewise-linear curve maps detune param to [0,1],
+     * then D = f0 * k_max * curve(detune), i.e. dInc = inc0 * detune_k.
+     * k_max = 0.10 (10% max detune for outermost pair) */
+    c->detune_k = DETUNE_K_MAX * detune_curve(engine->detune);
+
+    /* --- Non-linear spread curve ---
+     * spread^1.5 gives gentler onset (subtle at low, dramatic at high)
+     * Computed as spread * sqrt(spread) to avoid powf
+     * Floor ensures detuned voices never completely vanish */
+    float gs = engine->spread * sqrtf(engine->spread) * SIDE_GAIN_SCALE;
+    if (gs < SIDE_GAIN_FLOOR) gs = SIDE_GAIN_FLOOR;
+    c->side_gain = gs;
+
+    /* RMS normalization: consistent loudness regardless of spread
+     * Total energy = 1^2 + N_sides * gs^2; norm = 1/sqrt(total)
+     * Works correctly with stereo panning (constant-power preserves total energy) */
+    c->norm = 1.0f / sqrtf(1.0f + (float)(engine->num_oscs - 1) * gs * gs);
+
+    c->sub_level = engine->sub_level;
+
+    /* Master volume with polyphony headroom */
+    c->master_vol = engine->volume * 0.3f;
+}
+
+/* Per-sample increment of each control value across n samples */
+static inline void control_delta(const nsaw_control_t *from, const nsaw_control_t *to,
+                                 int n, nsaw_control_t *d) {
+    float inv_n = 1.0f / (float)n;
+    d->cutoff_hz     = (to->cutoff_hz     - from->cutoff_hz)     * inv_n;
+    d->k             = (to->k             - from->k)             * inv_n;
+    d->f_env_octaves = (to->f_env_octaves - from->f_env_octaves) * inv_n;
+    d->detune_k      = (to->detune_k      - from->detune_k)      * inv_n;
+    d->side_gain     = (to->side_gain     - from->side_gain)     * inv_n;
+    d->norm          = (to->norm          - from->norm)          * inv_n;
+    d->sub_level     = (to->sub_level     - from->sub_level)     * inv_n;
+    d->master_vol    = (to->master_vol    - from->master_vol)    * inv_n;
+}
+
+/* Control values n samples along a ramp */
+static inline void control_advance(nsaw_control_t *c, const nsaw_control_t *d, int n) {
+    float fn = (float)n;
+    c->cutoff_hz     += d->cutoff_hz     * fn;
+    c->k             += d->k             * fn;
+    c->f_env_octaves += d->f_env_octaves * fn;
+    c->detune_k      += d->detune_k      * fn;
+    c->side_gain     += d->side_gain     * fn;
+    c->norm          += d->norm          * fn;
+    c->sub_level     += d->sub_level     * fn;
+    c->master_vol    += d->master_vol    * fn;
+}
+
+void nsaw_engine_set_sample_rate(nsaw_engine_t *engine, float sample_rate) {
+    engine->sample_rate = sample_rate;
+    engine->hpf_coeff = 1.0f - 2.0f * (float)M_PI * HPF_HZ / sample_rate;
+
+    /* Drift coefficients are per control block at this rate */
+    if (engine->control_block) nsaw_engine_set_control_block(engine, engine->control_block);
+}
+
+/* Drift steps once per control block (or per part of one, see
+ * render_span). Match the per-sample filter's bandwidth over those N
+ * samples (coefficient a_c) and its output variance (noise scaled by
+ * sqrt(a * (2 - a_c) / (a_c * (2 - a))) ~ 1/sqrt(N)). */
+static void drift_step(const nsaw_engine_t *engine, int frames, float *coeff, float *noise_scale) {
+    float a = 2.0f * (float)M_PI * DRIFT_HZ / engine->sample_rate;
+    float a_c = 1.0f - powf(1.0f - a, (float)frames);
+    *coeff = a_c;
+    *noise_scale = sqrtf(a * (2.0f - a_c) / (a_c * (2.0f - a)));
+}
+
+void nsaw_engine_set_control_block(nsaw_engine_t *engine, int frames) {
+    if (frames < NSAW_MIN_CONTROL_BLOCK) frames = NSAW_MIN_CONTROL_BLOCK;
+    if (frames > NSAW_MAX_RENDER) frames = NSAW_MAX_RENDER;
+    engine->control_block = frames;
+    engine->ctrl_pos = 0;
+    drift_step(engine, frames, &engine->drift_coeff, &engine->drift_noise_scale);
+}
+
+/* Which stages a control block needs. Without the filter envelope and
+ * with cutoff and resonance holding, every voice shares one set of SVF
+ * coefficients for the whole block. */
+static int block_features(const nsaw_engine_t *engine, const nsaw_control_t *from,
+                          const nsaw_control_t *d, int frames) {
+    int f = 0;
+    if (from->sub_level > 0.001f || from->sub_level + d->sub_level * frames > 0.001f)
+        f |= FEAT_SUB;
+    if (!engine->fast_paths) return f | FEAT_FILTER | FEAT_FILTER_MOD;
+
+    int ramping = (d->cutoff_hz != 0.0f || d->k != 0.0f);
+    if (ramping || from->cutoff_hz < NSAW_FILTER_OPEN_HZ || from->k < NSAW_FILTER_OPEN_K)
+        f |= FEAT_FILTER;
+    /* A smoothed amount glides toward 0 without reaching it */
+    float env_end = from->f_env_octaves + d->f_env_octaves * frames;
+    if (ramping || from->f_env_octaves > NSAW_FILTER_ENV_MIN_OCT ||
+        env_end > NSAW_FILTER_ENV_MIN_OCT)
+        f |= FEAT_FILTER_MOD;
+    return f;
+}
+
+/* Contiguous voice ranges for the worker pool. Each job renders into its
+ * own scratch; the caller sums the job outputs in job order, so the mix
+ * does not depend on which thread ran which job. */
+typedef struct {
+    nsaw_engine_t *engine;
+    const render_plan_t *plan;
+    nsaw_voice_t *voices[NSAW_MAX_VOICES];
+    int first[NSAW_MAX_JOBS];
+    int count[NSAW_MAX_JOBS];
+    int culled[NSAW_MAX_JOBS];
+} render_jobs_t;
+
+static void render_job(void *ctx, int job) {
+    render_jobs_t *rj = (render_jobs_t*)ctx;
+    nsaw_render_scratch_t *s = &rj->engine->scratch[job];
+    int frames = rj->plan->frames;
+
+    memset(s->out_l, 0, frames * sizeof(float));
+    memset(s->out_r, 0, frames * sizeof(float));
+    rj->culled[job] = rj->engine->kernels->render_voices(rj->engine, rj->plan,
+                                    rj->voices + rj->first[job], rj->count[job],
+                                    s, s->out_l, s->out_r);
+}
+
+void nsaw_engine_set_worker_pool(nsaw_engine_t *engine, nsaw_worker_pool_t *pool) {
+    engine->pool = pool;
 }
 
 /* =====================================================================
- * Render block (stereo)
+ * Kernel dispatch
  * ===================================================================== */
 
-void nsaw_engine_render(nsaw_engine_t *engine, float *out_left, float *out_right, int frames) {
-    if (frames > NSAW_MAX_RENDER) frames = NSAW_MAX_RENDER;
+#ifndef HWCAP_FPHP
+#define HWCAP_FPHP (1 << 9)
+#define HWCAP_ASIMDHP (1 << 10)
+#endif
+#ifndef HWCAP_ASIMDDP
+#define HWCAP_ASIMDDP (1 << 20)
+#endif
 
-    float sr = engine->sample_rate;
+/* Whether this CPU runs a kernel table's ISA (unlinked variants are NULL) */
+static int kernels_supported(const nsaw_kernels_t *k) {
+    if (!k) return 0;
+    if (k == &nsaw_kernels_base) return 1;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (k == &nsaw_kernels_avx512)
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl");
+    if (k == &nsaw_kernels_avx2) return __builtin_cpu_supports("avx2");
+#elif defined(__aarch64__) && defined(__linux__)
+    if (k == &nsaw_kernels_armv82) {
+        unsigned long hw = getauxval(AT_HWCAP);
+        return (hw & HWCAP_FPHP) && (hw & HWCAP_ASIMDHP) && (hw & HWCAP_ASIMDDP);
+    }
+#endif
+    return 0;
+}
 
-    /* --- Precompute envelope coefficients --- */
+const nsaw_kernels_t *nsaw_kernels_select(const char *name) {
+    /* Best first */
+    const nsaw_kernels_t *const tables[] = {
+        &nsaw_kernels_avx512, &nsaw_kernels_avx2, &nsaw_kernels_armv82, &nsaw_kernels_base,
+    };
+    for (size_t i = 0; i < sizeof(tables) / sizeof(tables[0]); i++) {
+        if (!kernels_supported(tables[i])) continue;
+        if (!name || strcmp(name, tables[i]->name) == 0) return tables[i];
+    }
+    return &nsaw_kernels_base;
+}
 
-    float amp_attack_rate = 1.0f / (param_to_seconds(engine->attack) * sr);
-    float amp_decay_coeff = expf(-4.0f / (param_to_seconds(engine->decay) * sr));
-    float amp_sustain = engine->sustain;
-    float amp_release_coeff = expf(-4.0f / (param_to_seconds(engine->release) * sr));
+/* =====================================================================
+ * Render
+ * ===================================================================== */
 
-    float filt_attack_rate = 1.0f / (param_to_seconds(engine->f_attack) * sr);
-    float filt_decay_coeff = expf(-4.0f / (param_to_seconds(engine->f_decay) * sr));
-    float filt_sustain = engine->f_sustain;
-    float filt_release_coeff = expf(-4.0f / (param_to_seconds(engine->f_release) * sr));
+/* Render up to NSAW_MAX_RENDER frames */
+static void render_span(nsaw_engine_t *engine, float *out_left, float *out_right, int frames) {
+    float sr = engine->sample_rate;
+    render_plan_t plan;
+    plan.frames = frames;
 
-    /* --- Filter parameters --- */
+    /* --- Precompute envelope coefficients --- */
 
-    /* Resonance: Q from 0.5 to 20 */
-    float q = 0.5f + engine->resonance * 19.5f;
+    env_coeffs_t *ec = &plan.ec;
+    ec->amp_attack_rate = 1.0f / (param_to_seconds(engine->attack) * sr);
+    ec->amp_decay_coeff = expf(-4.0f / (param_to_seconds(engine->decay) * sr));
+    ec->amp_sustain = engine->sustain;
+    ec->amp_release_coeff = expf(-4.0f / (param_to_seconds(engine->release) * sr));
 
-    /* Filter envelope amount in octaves (0 to 8) */
-    float f_env_octaves = engine->f_amount * 8.0f;
+    ec->filt_attack_rate = 1.0f / (param_to_seconds(engine->f_attack) * sr);
+    ec->filt_decay_coeff = expf(-4.0f / (param_to_seconds(engine->f_decay) * sr));
+    ec->filt_sustain = engine->f_sustain;
+    ec->filt_release_coeff = expf(-4.0f / (param_to_seconds(engine->f_release) * sr));
 
     /* --- Pitch bend --- */
 
     float bend_semitones = engine->current_bend * engine->bend_range * 12.0f;
-    float bend_ratio = powf(2.0f, bend_semitones / 12.0f);
-
-    /* --- Master volume with polyphony headroom --- */
-
-    float master_vol = engine->volume * 0.3f;
+    plan.bend_ratio = powf(2.0f, bend_semitones / 12.0f);
 
     /* --- Clear output --- */
 
     memset(out_left, 0, frames * sizeof(float));
     memset(out_right, 0, frames * sizeof(float));
 
-    /* --- Process each polyphonic voice --- */
+    /* --- Control-rate sub-blocks ---
+     * Control values are derived for the whole engine and ramped linearly
+     * across each sub-block, so every voice sees the same values regardless
+     * of how many voices are sounding. Parameters cannot change during a
+     * render call, so the targets are the same for every sub-block: the
+     * first ramps from the previous values, the rest hold.
+     *
+     * Sub-blocks stay on the control-block grid across render calls. A
+     * call that ends mid-block (the plugin splits at MIDI events) leaves
+     * the ramp part way, and the next call finishes that block: the ramp
+     * still spans a whole control block and drift steps by the frames
+     * actually rendered. */
+
+    nsaw_control_t target;
+    compute_control(engine, &target);
+    if (!engine->ctrl_valid) {
+        engine->ctrl = target;
+        engine->ctrl_valid = 1;
+    }
+
+    int block = engine->control_block;
+    int pos = engine->ctrl_pos;
+    nsaw_control_t ctrl = engine->ctrl;
+    plan.num_blocks = 0;
+    int n;
+    for (int start = 0; start < frames; start += n) {
+        control_block_t *cb = &plan.blocks[plan.num_blocks++];
+        cb->start = start;
+        cb->phase = pos;
+        cb->ramp = block - pos;
+        cb->frames = frames - start;
+        if (cb->frames > cb->ramp) cb->frames = cb->ramp;
+        n = cb->frames;
+        cb->from = ctrl;
+        control_delta(&cb->from, &target, cb->ramp, &cb->delta);
+
+        if (cb->frames == block) {
+            cb->drift_coeff = engine->drift_coeff;
+            cb->drift_noise_scale = engine->drift_noise_scale;
+        } else {
+            drift_step(engine, cb->frames, &cb->drift_coeff, &cb->drift_noise_scale);
+        }
+        if (cb->frames < cb->ramp) {
+            control_advance(&ctrl, &cb->delta, cb->frames);
+            pos += cb->frames;
+        } else {
+            ctrl = target;
+            pos = 0;
+        }
+
+        cb->features = block_features(engine, &cb->from, &cb->delta, cb->frames);
+        float fc = cb->from.cutoff_hz;
+        if (fc > svf_max_cutoff(sr)) fc = svf_max_cutoff(sr);
+        if (fc < NSAW_SVF_MIN_HZ) fc = NSAW_SVF_MIN_HZ;
+        svf_coeffs(fc, cb->from.k, sr, &cb->svf);
+    }
+    engine->ctrl = ctrl;
+    engine->ctrl_pos = pos;
+
+    /* --- Collect sounding voices --- */
 
-    for (int vi = 0; vi < NSAW_MAX_VOICES; vi++) {
+    nsaw_voice_t *active[NSAW_MAX_VOICES];
+    int num_active = 0;
+    for (int vi = 0; vi < engine->num_voices; vi++) {
         nsaw_voice_t *v = &engine->voices[vi];
-        if (v->amp_env.stage == NSAW_ENV_OFF) continue;
-
-        float f0 = v->freq * bend_ratio;
-        float vel_gain = 1.0f - engine->vel_sens + engine->vel_sens * v->velocity;
-
-        for (int n = 0; n < frames; n++) {
-
-            /* --- Parameter smoothing (per-sample one-pole) --- */
-            engine->smooth_detune += (engine->detune - engine->smooth_detune) * SMOOTH_COEFF;
-            engine->smooth_spread += (engine->spread - engine->smooth_spread) * SMOOTH_COEFF;
-            engine->smooth_cutoff += (engine->cutoff - engine->smooth_cutoff) * SMOOTH_COEFF;
-
-            float cur_detune = engine->smooth_detune;
-            float cur_spread = engine->smooth_spread;
-
-            /* Cutoff: exponential mapping 20Hz to 20kHz (smoothed) */
-            float base_cutoff_hz = 20.0f * powf(1000.0f, engine->smooth_cutoff);
-            if (base_cutoff_hz > 20000.0f) base_cutoff_hz = 20000.0f;
-
-            /* --- Detune scaling ---
-             * Piecewise-linear curve maps detune param to [0,1],
-             * then D = f0 * k_max * curve(detune).
-             * k_max = 0.10 (10% max detune for outermost pair) */
-            float D = f0 * DETUNE_K_MAX * detune_curve(cur_detune);
-            float dInc = D / sr;
-
-            /* Base phase increment */
-            float inc0 = f0 / sr;
-
-            /* --- Non-linear spread curve ---
-             * spread^1.5 gives gentler onset (subtle at low, dramatic at high)
-             * Computed as spread * sqrt(spread) to avoid powf
-             * Floor ensures detuned voices never completely vanish */
-            float gs = cur_spread * sqrtf(cur_spread) * SIDE_GAIN_SCALE;
-            if (gs < SIDE_GAIN_FLOOR) gs = SIDE_GAIN_FLOOR;
-
-            /* RMS normalization: consistent loudness regardless of spread
-             * Total energy = 1^2 + N_sides * gs^2; norm = 1/sqrt(total)
-             * Works correctly with stereo panning (constant-power preserves total energy) */
-            float norm = 1.0f / sqrtf(1.0f + (float)(engine->num_oscs - 1) * gs * gs);
-
-            /* --- Generate and mix all oscillator voices (stereo) --- */
-
-            float osc_mix_l = 0.0f;
-            float osc_mix_r = 0.0f;
-
-            for (int j = 0; j < engine->num_oscs; j++) {
-                /* Analog pitch drift: one-pole lowpass filtered white noise
-                 * Creates slow, independent pitch wander per oscillator (~0.35 cents) */
-                float noise = rand_float(&engine->rng_state) * 2.0f - 1.0f;
-                v->drift[j] += (noise - v->drift[j]) * DRIFT_COEFF;
-                float drift_mult = 1.0f + v->drift[j] * DRIFT_AMOUNT;
-
-                /* Per-voice increment: inc[j] = (inc0 + coeff[j] * dInc) * drift */
-                float inc_j = (inc0 + engine->detune_coeff[j] * dInc) * drift_mult;
-                if (inc_j < 0.0f) inc_j = 0.0f;  /* Safety clamp */
-
-                /* Advance and wrap phase */
-                v->phase[j] += inc_j;
-                if (v->phase[j] >= 1.0f) v->phase[j] -= 1.0f;
-
-                /* Naive sawtooth: map phase [0,1) to [-1,+1) */
-                float saw = 2.0f * v->phase[j] - 1.0f;
-
-                /* PolyBLEP anti-aliasing */
-                saw -= polyblep(v->phase[j], inc_j);
-
-                /* Apply gain (center=1.0, sides=gs) and stereo pan */
-                float gain = (j == 0) ? 1.0f : gs;
-                osc_mix_l += saw * gain * engine->pan_l[j];
-                osc_mix_r += saw * gain * engine->pan_r[j];
-            }
-
-            /* RMS-based normalization for consistent loudness */
-            osc_mix_l *= norm;
-            osc_mix_r *= norm;
-
-            /* --- Sub oscillator (sine, center-panned) --- */
-            if (engine->sub_level > 0.001f) {
-                float sub_mult = (engine->sub_octave == -2) ? 0.25f :
-                                 (engine->sub_octave == -1) ? 0.5f : 1.0f;
-                float sub_inc = inc0 * sub_mult;
-                v->sub_phase += sub_inc;
-                if (v->sub_phase >= 1.0f) v->sub_phase -= 1.0f;
-                float sub = sinf(v->sub_phase * 2.0f * (float)M_PI) * engine->sub_level;
-                osc_mix_l += sub * 0.7071f;  /* center pan */
-                osc_mix_r += sub * 0.7071f;
-            }
-
-            /* --- Post-mix DC-blocking HPF (stereo) ---
-             * y[n] = x[n] - x[n-1] + R * y[n-1]
-             * 1-pole highpass, cutoff ~20Hz */
-            float hpf_l = osc_mix_l - v->hpf_x_prev_l + HPF_R * v->hpf_y_prev_l;
-            v->hpf_x_prev_l = osc_mix_l;
-            v->hpf_y_prev_l = hpf_l;
-
-            float hpf_r = osc_mix_r - v->hpf_x_prev_r + HPF_R * v->hpf_y_prev_r;
-            v->hpf_x_prev_r = osc_mix_r;
-            v->hpf_y_prev_r = hpf_r;
-
-            /* --- Process envelopes --- */
-
-            process_envelope(&v->amp_env, amp_attack_rate, amp_decay_coeff,
-                           amp_sustain, amp_release_coeff);
-            process_envelope(&v->filt_env, filt_attack_rate, filt_decay_coeff,
-                           filt_sustain, filt_release_coeff);
-
-            /* --- Resonant lowpass filter with envelope modulation (stereo) --- */
-
-            float mod_cutoff_hz = base_cutoff_hz * powf(2.0f, v->filt_env.level * f_env_octaves);
-            if (mod_cutoff_hz > 20000.0f) mod_cutoff_hz = 20000.0f;
-            if (mod_cutoff_hz < 20.0f) mod_cutoff_hz = 20.0f;
-
-            /* TPT/SVF coefficients (shared between L and R) */
-            float g = tanf((float)M_PI * mod_cutoff_hz / sr);
-            float k = 1.0f / q;
-            float a1 = 1.0f / (1.0f + g * (g + k));
-            float a2 = g * a1;
-            float a3 = g * a2;
-
-            /* L channel SVF */
-            float t3_l = hpf_l - v->ic2eq_l;
-            float t1_l = a1 * v->ic1eq_l + a2 * t3_l;
-            float t2_l = v->ic2eq_l + a2 * v->ic1eq_l + a3 * t3_l;
-            v->ic1eq_l = 2.0f * t1_l - v->ic1eq_l;
-            v->ic2eq_l = 2.0f * t2_l - v->ic2eq_l;
-
-            /* R channel SVF */
-            float t3_r = hpf_r - v->ic2eq_r;
-            float t1_r = a1 * v->ic1eq_r + a2 * t3_r;
-            float t2_r = v->ic2eq_r + a2 * v->ic1eq_r + a3 * t3_r;
-            v->ic1eq_r = 2.0f * t1_r - v->ic1eq_r;
-            v->ic2eq_r = 2.0f * t2_r - v->ic2eq_r;
-
-            /* --- Apply amp envelope and velocity --- */
-
-            float amp = v->amp_env.level * vel_gain * master_vol;
-            out_left[n]  += t2_l * amp;
-            out_right[n] += t2_r * amp;
+        if (v->amp_env.stage == NSAW_ENV_OFF) {
+            v->culled = 0;
+            continue;
+        }
+        active[num_active++] = v;
+    }
+
+    /* --- Render voices, split across the worker pool when worthwhile --- */
+
+    int jobs = nsaw_worker_pool_threads(engine->pool) + 1;
+    if (jobs > NSAW_MAX_JOBS) jobs = NSAW_MAX_JOBS;
+    if (jobs > num_active) jobs = num_active;
+
+    if (jobs < 2 || num_active < NSAW_MT_MIN_VOICES) {
+        engine->culled_voices = engine->kernels->render_voices(engine, &plan, active, num_active,
+                                                               &engine->scratch[0],
+                                                               out_left, out_right);
+        return;
+    }
+
+    render_jobs_t rj;
+    rj.engine = engine;
+    rj.plan = &plan;
+    memcpy(rj.voices, active, num_active * sizeof(active[0]));
+    for (int j = 0, first = 0; j < jobs; j++) {
+        rj.first[j] = first;
+        rj.count[j] = num_active / jobs + (j < num_active % jobs ? 1 : 0);
+        first += rj.count[j];
+    }
+
+    nsaw_worker_pool_run(engine->pool, render_job, &rj, jobs);
+
+    int culled = 0;
+    for (int j = 0; j < jobs; j++) {
+        const nsaw_render_scratch_t *s = &engine->scratch[j];
+        for (int i = 0; i < frames; i++) {
+            out_left[i] += s->out_l[i];
+            out_right[i] += s->out_r[i];
         }
+        culled += rj.culled[j];
+    }
+    engine->culled_voices = culled;
+}
+
+/* Any frame count, in NSAW_MAX_RENDER spans: the render plan, voice
+ * scratch and job buffers are sized for one span and stay cache-resident */
+void nsaw_engine_render(nsaw_engine_t *engine, float *out_left, float *out_right, int frames) {
+    for (int start = 0; start < frames; start += NSAW_MAX_RENDER) {
+        int n = frames - start;
+        if (n > NSAW_MAX_RENDER) n = NSAW_MAX_RENDER;
+        render_span(engine, out_left + start, out_right + start, n);
     }
 }
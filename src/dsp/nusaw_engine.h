@@ -1,27 +1,42 @@
 /*
  * nusaw_engine.h - NuSaw polyphonic synthesizer engine
  *
- * Detuned multi-voice sawtooth oscillator (7 voices: 1 center + 3 pairs)
- * with PolyBLEP anti-aliasing, analog pitch drift, stereo panning of
- * detuned pairs, sine sub oscillator (configurable octave offset),
- * post-mix 1-pole DC-blocking HPF, 2nd-order resonant lowpass filter
- * (TPT/SVF), ADSR amp and filter envelopes.
+ * Detuned multi-voice sawtooth oscillator (7 voices: 1 center + 3 pairs).
+ * Anti-aliasing is selectable (naive, DPW, PolyBLEP, minBLEP or auto by
+ * note frequency), or a mip-mapped wavetable core replaces it. Analog
+ * pitch drift, stereo panning of detuned pairs, sine sub oscillator
+ * (configurable octave offset). Post-mix 1-pole DC-blocking HPF, 2nd-order
+ * resonant lowpass filter (TPT/SVF), ADSR amp and filter envelopes.
+ * Resonant patches can run the voice path at 2x/4x with a halfband
+ * decimator.
  *
- * 8-voice polyphony with oldest-note stealing.
+ * 1-32 voice polyphony (default 8) with oldest-note stealing.
  */
 
 #ifndef NUSAW_ENGINE_H
 #define NUSAW_ENGINE_H
 
 #include <stdint.h>
+#include "nusaw_osc_tables.h"
+#include "nusaw_halfband.h"
+#include "nusaw_worker_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define NSAW_MAX_VOICES 8       /* Polyphonic voices */
-#define NSAW_SAMPLE_RATE 44100
-#define NSAW_MAX_RENDER 256
+/* Render kernels of one ISA build (nusaw_kernels.h) */
+typedef struct nsaw_kernels nsaw_kernels_t;
+
+#define NSAW_MAX_VOICES 32      /* Voice pool size (polyphony limit) */
+#define NSAW_DEFAULT_VOICES 8   /* Polyphony unless configured */
+#define NSAW_CACHE_LINE 64
+#define NSAW_SAMPLE_RATE 44100  /* Until nsaw_engine_set_sample_rate() */
+#define NSAW_MAX_RENDER 256     /* Frames per internal render span */
+
+/* Control-rate sub-block size in frames (configurable, 8 to NSAW_MAX_RENDER) */
+#define NSAW_DEFAULT_CONTROL_BLOCK 32
+#define NSAW_MIN_CONTROL_BLOCK 8
 
 /* Detuned oscillator configuration (runtime-configurable)
  * M detuned pairs + 1 center = 2*M+1 total oscillator voices per poly voice
@@ -30,6 +45,100 @@ extern "C" {
 #define NSAW_MAX_OSC_VOICES (2 * NSAW_MAX_DETUNE_PAIRS + 1)  /* 25 */
 #define NSAW_DEFAULT_OSC_VOICES 7
 
+/* Analog pitch drift: uniform noise per oscillator through a one-pole
+ * lowpass at DRIFT_HZ (coefficient 2*pi*DRIFT_HZ/sample_rate per sample,
+ * converted to control rate in nsaw_engine_set_control_block). The state
+ * v->drift[] scales pitch by 1 + drift * DRIFT_AMOUNT (0.02% of frequency,
+ * ~0.35 cents, per unit of drift). */
+#define DRIFT_HZ  8.0f
+#define DRIFT_AMOUNT 0.0002f
+
+/* Oscillator bank kernel (see nusaw_osc_bank.h) */
+typedef enum {
+    NSAW_OSC_KERNEL_SCALAR = 0, /* Reference loop, one oscillator at a time */
+    NSAW_OSC_KERNEL_SIMD,       /* NEON/SSE/AVX across oscillators, per sample */
+    NSAW_OSC_KERNEL_BLOCK       /* SIMD, per block, specialized per saw count (default) */
+} nsaw_osc_kernel_t;
+
+/* Saw phase accumulator for the naive and PolyBLEP tiers (the other
+ * tiers always run float phases; voices convert when they switch) */
+typedef enum {
+    NSAW_PHASE_FLOAT = 0,       /* float in [0, 1), compare-and-subtract wrap */
+    NSAW_PHASE_FIXED            /* uint32 cycle fraction, wraps by overflow (default) */
+} nsaw_phase_mode_t;
+
+/* Saw oscillator core */
+typedef enum {
+    NSAW_OSC_MODE_ANALYTIC = 0, /* Phase-derived saw, anti-aliased per osc_quality */
+    NSAW_OSC_MODE_WAVETABLE     /* Mip-mapped band-limited saw tables */
+} nsaw_osc_mode_t;
+
+/* Saw anti-aliasing tier (analytic mode; AUTO picks one per voice) */
+typedef enum {
+    NSAW_OSC_QUALITY_AUTO = 0,  /* By note frequency (thresholds below) */
+    NSAW_OSC_QUALITY_NAIVE,     /* No anti-aliasing (eco) */
+    NSAW_OSC_QUALITY_DPW,       /* 2nd-order differentiated parabolic wave */
+    NSAW_OSC_QUALITY_POLYBLEP,  /* 2-sample polynomial BLEP */
+    NSAW_OSC_QUALITY_MINBLEP,   /* Table-driven minimum-phase BLEP */
+    NSAW_OSC_QUALITY_COUNT
+} nsaw_osc_quality_t;
+
+/* AUTO tier thresholds on the note frequency (Hz), for a voice rendering
+ * at NSAW_SAMPLE_RATE (scaled to the voice's actual rate) */
+#define NSAW_AUTO_NAIVE_BELOW_HZ    50.0f
+#define NSAW_AUTO_DPW_BELOW_HZ      400.0f
+#define NSAW_AUTO_POLYBLEP_BELOW_HZ 1600.0f
+
+/* Voice oversampling (oscillators, HPF and SVF run at N x, then decimate).
+ * Chosen per voice at note-on so a voice never changes rate mid-note. */
+typedef enum {
+    NSAW_OVERSAMPLE_AUTO_2X = 0,    /* 2x when the patch crosses the thresholds */
+    NSAW_OVERSAMPLE_AUTO_4X,        /* 4x when the patch crosses the thresholds */
+    NSAW_OVERSAMPLE_OFF,
+    NSAW_OVERSAMPLE_COUNT
+} nsaw_oversample_t;
+
+#define NSAW_MAX_OVERSAMPLE 4
+#define NSAW_OS_RESONANCE_THRESHOLD 0.5f    /* resonance param (Q ~10) */
+#define NSAW_OS_CUTOFF_THRESHOLD_HZ 3000.0f /* cutoff incl. full filter env
+                                             * (at NSAW_SAMPLE_RATE, scaled) */
+
+/* Silent-voice culling: a voice whose amp envelope is below this level and
+ * can only stay there (decay/sustain toward a silent sustain, or release)
+ * skips oscillator and filter work; only its envelopes keep running */
+#define NSAW_CULL_LEVEL 1.5849e-5f  /* -96 dB */
+
+/* Filter bypass: the SVF is skipped while the cutoff is at the top of its
+ * range (within smoothing) with no resonance */
+#define NSAW_FILTER_OPEN_HZ 19900.0f
+#define NSAW_FILTER_OPEN_K  1.99f       /* SVF damping; 2.0 = resonance 0 */
+
+/* Filter envelope depth (octaves) below which the cutoff is treated as
+ * unmodulated and SVF coefficients are shared per block */
+#define NSAW_FILTER_ENV_MIN_OCT 0.001f
+
+/* Unison level of detail: per voice and block, outer detune pairs that
+ * add nothing audible are not rendered (see voice_saws()) */
+#define NSAW_LOD_CLUSTER_HZ 0.05f    /* outer pair beat below this: stack is coincident */
+#define NSAW_LOD_QUIET_LEVEL 0.004f  /* amp envelope -48 dB: tail keeps the center pair */
+
+/* CPU governor degradation (engine->degrade, set from nusaw_governor.h).
+ * Levels are cumulative; 0 is full quality. */
+#define NSAW_DEGRADE_QUIET_SAWS 1   /* releasing/quiet voices play NSAW_QUIET_SAWS saws */
+#define NSAW_DEGRADE_CHEAP_TIERS 2  /* minBLEP -> PolyBLEP; new notes not oversampled */
+#define NSAW_DEGRADE_CAP_SAWS 3     /* every voice plays at most NSAW_CAPPED_SAWS saws */
+#define NSAW_DEGRADE_CAP_VOICES 4   /* new notes limited to half the polyphony */
+#define NSAW_DEGRADE_MAX 4
+#define NSAW_QUIET_SAWS 3
+#define NSAW_CAPPED_SAWS 7
+#define NSAW_QUIET_LEVEL 0.0316f    /* amp envelope -30 dB */
+
+/* Multi-core rendering: voices are split into at most NSAW_MAX_JOBS jobs
+ * (workers + the audio thread); fewer active voices than
+ * NSAW_MT_MIN_VOICES render on the audio thread alone */
+#define NSAW_MAX_JOBS (NSAW_MAX_WORKERS + 1)
+#define NSAW_MT_MIN_VOICES 3
+
 /* Envelope stages */
 typedef enum {
     NSAW_ENV_OFF = 0,
@@ -45,21 +154,39 @@ typedef struct {
     float level;
 } nsaw_envelope_t;
 
-/* Per-polyphonic-voice state */
-typedef struct {
+/* Per-polyphonic-voice state. Cache-line aligned so voices rendered by
+ * different jobs never share a line. */
+typedef struct __attribute__((aligned(NSAW_CACHE_LINE))) {
     int active;
     int note;
     float velocity;
     float freq;                         /* Base frequency in Hz */
 
-    /* Multi-voice sawtooth phases (up to 25 oscillators) */
-    float phase[NSAW_MAX_OSC_VOICES];
+    /* Multi-voice sawtooth phases (up to 25 oscillators, SIMD-aligned):
+     * float, or fixed-point (see nsaw_osc_bank_tick_q) while phase_fixed */
+    float phase[NSAW_MAX_OSC_VOICES] __attribute__((aligned(16)));
+    uint32_t phase_q[NSAW_MAX_OSC_VOICES] __attribute__((aligned(16)));
+    int phase_fixed;
 
     /* Analog pitch drift state per oscillator (lowpass-filtered noise) */
     float drift[NSAW_MAX_OSC_VOICES];
+    uint32_t drift_key;                 /* Per-note noise stream key */
+    uint32_t drift_counter;             /* Drift steps since note-on */
+
+    /* Anti-aliasing tier state */
+    int aa_tier;                        /* Tier in use (-1 = none yet) */
+    int saws;                           /* Unison LOD: saws in the last block (-1 = new note) */
+    int lod_from;                       /* Unison LOD: saws when that block began (fade) */
+    float dpw_z[NSAW_MAX_OSC_VOICES] __attribute__((aligned(16)));  /* DPW: previous s^2 */
+    nsaw_minblep_state_t minblep;       /* minBLEP: pending corrections */
 
-    /* Sub oscillator phase (sine, -1 octave) */
-    float sub_phase;
+    /* Oversampling (factor latched at note-on) */
+    int os_factor;                      /* 1, 2 or 4 */
+    nsaw_halfband_t dec_l[2];           /* [0] N->N/2, [1] 2->1 (4x only) */
+    nsaw_halfband_t dec_r[2];
+
+    /* Sub oscillator: unit phasor (cos, sin) rotated once per sample */
+    float sub_re, sub_im;
 
     /* Post-mix DC-blocking HPF state (1-pole, stereo) */
     float hpf_x_prev_l, hpf_y_prev_l;
@@ -74,17 +201,46 @@ typedef struct {
     float ic1eq_r, ic2eq_r;
 
     uint32_t age;                       /* For voice stealing */
+    int culled;                         /* Silent in the last control block */
 } nsaw_voice_t;
 
+/* Voice-independent control values, derived once per control block */
+typedef struct {
+    float cutoff_hz;        /* Base filter cutoff in Hz */
+    float k;                /* SVF damping (1/Q) */
+    float f_env_octaves;    /* Filter envelope depth in octaves */
+    float detune_k;         /* Outer-pair detune as fraction of f0 */
+    float side_gain;        /* Side oscillator gain (spread curve) */
+    float norm;             /* RMS mix normalization */
+    float sub_level;        /* Sub oscillator level */
+    float master_vol;       /* Master volume with polyphony headroom */
+} nsaw_control_t;
+
+/* Per-job render scratch: one voice's oscillator mix at its internal
+ * rate, the voice-interleaved input of the voice-lane post stage
+ * (lane_buf[n * stride + lane], stride = the job's voices padded to whole
+ * lane groups) and the job's stereo output */
+typedef struct {
+    float osc_buf_l[NSAW_MAX_RENDER * NSAW_MAX_OVERSAMPLE];
+    float osc_buf_r[NSAW_MAX_RENDER * NSAW_MAX_OVERSAMPLE];
+    float lane_buf_l[NSAW_MAX_RENDER * NSAW_MAX_VOICES];
+    float lane_buf_r[NSAW_MAX_RENDER * NSAW_MAX_VOICES];
+    float out_l[NSAW_MAX_RENDER];
+    float out_r[NSAW_MAX_RENDER];
+} nsaw_render_scratch_t;
+
 /* Engine state */
 typedef struct {
-    float sample_rate;
+    float sample_rate;      /* Render rate (Hz) */
+    float hpf_coeff;        /* DC-blocking HPF pole at sample_rate */
 
-    /* Polyphonic voices */
+    /* Polyphonic voices: a preallocated pool, of which only the first
+     * num_voices are allocated to notes or rendered */
     nsaw_voice_t voices[NSAW_MAX_VOICES];
+    int num_voices;         /* Polyphony (1 to NSAW_MAX_VOICES) */
     uint32_t voice_counter;
 
-    /* PRNG state for random phase and drift */
+    /* PRNG state for random phase and drift stream keys */
     uint32_t rng_state;
 
     /* Parameters (0.0 to 1.0 unless noted) */
@@ -119,13 +275,41 @@ typedef struct {
 
     int octave_transpose;   /* -3 to +3 octaves */
 
+    int osc_kernel;         /* nsaw_osc_kernel_t */
+    int osc_quality;        /* nsaw_osc_quality_t */
+    int osc_mode;           /* nsaw_osc_mode_t */
+    int oversample;         /* nsaw_oversample_t */
+    int unison_lod;         /* Per-voice unison level of detail (1 = on) */
+    int phase_mode;         /* nsaw_phase_mode_t */
+    int fast_paths;         /* Feature-specialized voice kernels (1 = on) */
+
     /* Pitch bend state */
     float current_bend;     /* -1.0 to 1.0 */
 
-    /* Smoothed parameter state (for zipper-free modulation) */
-    float smooth_detune;
-    float smooth_spread;
-    float smooth_cutoff;
+    /* Control-rate stage: values reached at the end of the last render;
+     * the rest of the control block ramps linearly from here to the new
+     * targets */
+    int control_block;      /* Sub-block size in frames */
+    float drift_coeff;      /* Drift lowpass coefficient per control block */
+    float drift_noise_scale;/* Drift noise amplitude per control block */
+    nsaw_control_t ctrl;
+    int ctrl_pos;           /* Frames into the current control block */
+    int ctrl_valid;         /* 0 = snap to targets on next render */
+
+    /* Voices skipped as silent in the last control block (see NSAW_CULL_LEVEL) */
+    int culled_voices;
+
+    /* CPU governor degradation level (NSAW_DEGRADE_*, 0 = full quality) */
+    int degrade;
+
+    /* Render kernels (nsaw_kernels_base until the host picks a table) */
+    const nsaw_kernels_t *kernels;
+
+    /* Multi-core rendering (NULL = audio thread only; not owned) */
+    nsaw_worker_pool_t *pool;
+
+    /* Render scratch, one per job (scratch[0] for single-threaded renders) */
+    nsaw_render_scratch_t scratch[NSAW_MAX_JOBS];
 
 } nsaw_engine_t;
 
@@ -135,13 +319,29 @@ void nsaw_engine_init(nsaw_engine_t *engine);
 /* Update oscillator configuration (call when saw count changes) */
 void nsaw_engine_update_osc_config(nsaw_engine_t *engine, int num_oscs);
 
+/* Set the render rate in Hz; rate-dependent coefficients follow */
+void nsaw_engine_set_sample_rate(nsaw_engine_t *engine, float sample_rate);
+
+/* Set control-rate sub-block size in frames (clamped) */
+void nsaw_engine_set_control_block(nsaw_engine_t *engine, int frames);
+
+/* Set polyphony (clamped to 1..NSAW_MAX_VOICES). Voices beyond the new
+ * limit are silenced immediately. */
+void nsaw_engine_set_polyphony(nsaw_engine_t *engine, int voices);
+
+/* Attach a worker pool for parallel voice rendering (NULL to detach).
+ * Not real-time safe against a concurrent render. */
+void nsaw_engine_set_worker_pool(nsaw_engine_t *engine, nsaw_worker_pool_t *pool);
+
 /* MIDI handlers */
 void nsaw_engine_note_on(nsaw_engine_t *engine, int note, float velocity);
 void nsaw_engine_note_off(nsaw_engine_t *engine, int note);
 void nsaw_engine_pitch_bend(nsaw_engine_t *engine, float bend);
 void nsaw_engine_all_notes_off(nsaw_engine_t *engine);
 
-/* Render audio block (stereo float output) */
+/* Render audio (stereo float output, any frame count). Control blocks
+ * carry over between calls: a render split into several calls ramps
+ * controls, drift and LOD fades as a single call would. */
 void nsaw_engine_render(nsaw_engine_t *engine, float *out_left, float *out_right, int frames);
 
 #ifdef __cplusplus
@@ -0,0 +1,79 @@
+/*
+ * nusaw_governor.h - CPU-budget governor
+ *
+ * Tracks the wall-clock cost of each render block against its deadline
+ * (frames / sample rate) and steps a degradation level up when the load
+ * crosses the target, and back down once there is clear headroom:
+ *
+ *   load      fast attack (jumps to any higher block load), slow release
+ *   step up   load > target, at most every NSAW_GOV_UP_HOLD blocks
+ *   step down load < target * NSAW_GOV_DOWN_RATIO, at most every
+ *             NSAW_GOV_DOWN_HOLD blocks
+ *
+ * The load is re-measured from scratch after each step, so a peak from
+ * before a step up cannot push the level further by itself.
+ *
+ * The level itself means nothing here; the engine maps it to cheaper
+ * rendering (see NSAW_DEGRADE_* in nusaw_engine.h).
+ */
+
+#ifndef NUSAW_GOVERNOR_H
+#define NUSAW_GOVERNOR_H
+
+#include <time.h>
+
+#define NSAW_GOV_DEFAULT_TARGET 0.75f  /* fraction of the block deadline */
+#define NSAW_GOV_RELEASE 0.02f         /* per-block load decay coefficient */
+#define NSAW_GOV_UP_HOLD 4             /* blocks between steps up (~12 ms) */
+#define NSAW_GOV_DOWN_HOLD 128         /* blocks between steps down (~370 ms) */
+#define NSAW_GOV_DOWN_RATIO 0.6f       /* restore below 60% of the target */
+
+typedef struct {
+    float target;   /* Load threshold (0 = governor off) */
+    float load;     /* Smoothed block load (1.0 = deadline) */
+    int level;      /* Current degradation level */
+    int max_level;  /* Highest level the consumer implements */
+    int hold;       /* Blocks until the level may change again */
+} nsaw_governor_t;
+
+static inline void nsaw_governor_init(nsaw_governor_t *gov, float target, int max_level) {
+    gov->target = target;
+    gov->load = 0.0f;
+    gov->level = 0;
+    gov->max_level = max_level;
+    gov->hold = 0;
+}
+
+/* Monotonic wall clock in seconds */
+static inline double nsaw_governor_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Feed one block's render time; returns the level for the next block */
+static inline int nsaw_governor_update(nsaw_governor_t *gov, double elapsed, double deadline) {
+    float load = (float)(elapsed / deadline);
+    if (load > gov->load) gov->load = load;
+    else gov->load += (load - gov->load) * NSAW_GOV_RELEASE;
+
+    if (gov->target <= 0.0f) {
+        gov->level = 0;
+        return 0;
+    }
+
+    if (gov->hold > 0) {
+        gov->hold--;
+    } else if (gov->load > gov->target && gov->level < gov->max_level) {
+        gov->level++;
+        gov->hold = NSAW_GOV_UP_HOLD;
+        gov->load = 0.0f;
+    } else if (gov->load < gov->target * NSAW_GOV_DOWN_RATIO && gov->level > 0) {
+        gov->level--;
+        gov->hold = NSAW_GOV_DOWN_HOLD;
+        gov->load = 0.0f;
+    }
+    return gov->level;
+}
+
+#endif /* NUSAW_GOVERNOR_H */
@@ -0,0 +1,70 @@
+/*
+ * nusaw_halfband.h - Polyphase halfband decimator (2:1)
+ *
+ * 47-tap Kaiser-windowed (beta 7) halfband lowpass: passband to 0.2 fs,
+ * stopband from 0.3 fs at -70 dB (fs = input rate). Every other tap is zero
+ * except the 0.5 center, so the filter splits into two polyphase branches:
+ *
+ *   y[m] = sum_q c[q] * x[2m+1-2q]  +  0.5 * x[2m-22]
+ *          (odd branch, 24 taps)       (even branch, pure delay)
+ *
+ * The odd branch history is mirrored (written twice) so the 24-tap dot
+ * product always reads one contiguous window, newest sample first.
+ * Latency: 23 input samples (11.5 output samples).
+ *
+ * Cascade two stages for 4:1.
+ */
+
+#ifndef NUSAW_HALFBAND_H
+#define NUSAW_HALFBAND_H
+
+#include "nusaw_osc_bank.h"  /* ob_* lane primitives, NSAW_ALIGNED */
+
+#define NSAW_HB_TAPS 24          /* odd branch taps (multiple of 8) */
+#define NSAW_HB_CENTER_DELAY 11  /* even branch delay in output samples */
+#define NSAW_HB_EVEN_SIZE 16     /* even branch ring (power of two > delay) */
+
+typedef struct {
+    float hist[2 * NSAW_HB_TAPS] NSAW_ALIGNED;  /* odd branch, mirrored */
+    float even[NSAW_HB_EVEN_SIZE];              /* even branch delay ring */
+    int pos;                                    /* newest odd sample in hist */
+    int epos;                                   /* next write in even[] */
+} nsaw_halfband_t;
+
+static const float nsaw_hb_coeffs[NSAW_HB_TAPS] NSAW_ALIGNED = {
+    -8.208760425e-05f, 3.905097168e-04f, -1.070848577e-03f, 2.347397838e-03f,
+    -4.513210055e-03f, 7.952738124e-03f, -1.320476243e-02f, 2.113719900e-02f,
+    -3.346170672e-02f, 5.453258828e-02f, -1.003915687e-01f, 3.163637511e-01f,
+     3.163637511e-01f, -1.003915687e-01f, 5.453258828e-02f, -3.346170672e-02f,
+     2.113719900e-02f, -1.320476243e-02f, 7.952738124e-03f, -4.513210055e-03f,
+     2.347397838e-03f, -1.070848577e-03f, 3.905097168e-04f, -8.208760425e-05f,
+};
+
+static inline void nsaw_halfband_reset(nsaw_halfband_t *hb) {
+    for (int i = 0; i < 2 * NSAW_HB_TAPS; i++) hb->hist[i] = 0.0f;
+    for (int i = 0; i < NSAW_HB_EVEN_SIZE; i++) hb->even[i] = 0.0f;
+    hb->pos = 0;
+    hb->epos = 0;
+}
+
+/* Consume two input samples (x0 earlier, x1 later), return one output */
+static inline float nsaw_halfband_decimate(nsaw_halfband_t *hb, float x0, float x1) {
+    /* Even branch: delayed center tap */
+    hb->even[hb->epos & (NSAW_HB_EVEN_SIZE - 1)] = x0;
+    float center = hb->even[(hb->epos - NSAW_HB_CENTER_DELAY) & (NSAW_HB_EVEN_SIZE - 1)];
+    hb->epos++;
+
+    /* Odd branch: push x1 (newest first) and convolve */
+    hb->pos = (hb->pos == 0) ? NSAW_HB_TAPS - 1 : hb->pos - 1;
+    hb->hist[hb->pos] = x1;
+    hb->hist[hb->pos + NSAW_HB_TAPS] = x1;
+    const float *w = hb->hist + hb->pos;
+
+    ob_vf acc = ob_set1(0.0f);
+    for (int q = 0; q < NSAW_HB_TAPS; q += OB_LANES)
+        acc = ob_add(acc, ob_mul(ob_load(w + q), ob_load(nsaw_hb_coeffs + q)));
+
+    return ob_hsum(acc) + 0.5f * center;
+}
+
+#endif /* NUSAW_HALFBAND_H */
@@ -0,0 +1,1085 @@
+/*
+ * nusaw_kernels.cpp - Voice rendering and output stage kernels
+ *
+ * Everything that runs per voice and sample: envelopes, the saw bank,
+ * mix normalization and sub oscillator, DC-blocking HPF, SVF,
+ * decimation and amp (scalar and voice-lane paths), plus the plugin's
+ * soft clip and int16 conversion. The render plan comes from
+ * nsaw_engine_render().
+ *
+ * Compiled once per ISA level with -DNSAW_KERNELS_ISA=<name> (none for
+ * the base build). All functions have internal linkage; each build
+ * exports only its nsaw_kernels_<name> table (see nusaw_kernels.h).
+ */
+
+#include "nusaw_kernels.h"
+#include "nusaw_denormal.h"
+#include "nusaw_osc_bank.h"
+#include "nusaw_osc_block.h"
+#include "nusaw_fastmath.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef NSAW_KERNELS_ISA
+#define NSAW_KERNELS_ISA base
+#endif
+#define NSAW_KERNELS_PASTE(a, b) a##b
+#define NSAW_KERNELS_TABLE(isa) NSAW_KERNELS_PASTE(nsaw_kernels_, isa)
+
+/* =====================================================================
+ * Helpers
+ * ===================================================================== */
+
+/* Counter-based noise for analog drift: a stateless 32-bit integer hash
+ * (lowbias32) of (counter, key). No serial state is shared between
+ * oscillators or voices, so a whole bank can be generated in parallel. */
+static inline uint32_t hash32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+/* Uniform noise in [-1, 1) for oscillator stream `key` at step `counter` */
+static inline float drift_noise(uint32_t counter, uint32_t key) {
+    uint32_t h = hash32(counter * 0x9E3779B9u ^ key);
+    return (float)(h >> 9) * (2.0f / (float)0x800000) - 1.0f;
+}
+
+/* =====================================================================
+ * Envelope processing (per sample)
+ * ===================================================================== */
+
+static inline void process_envelope(nsaw_envelope_t *env,
+                                     float attack_rate, float decay_coeff,
+                                     float sustain_level, float release_coeff) {
+    switch (env->stage) {
+        case NSAW_ENV_ATTACK:
+            env->level += attack_rate;
+            if (env->level >= 1.0f) {
+                env->level = 1.0f;
+                env->stage = NSAW_ENV_DECAY;
+            }
+            break;
+        case NSAW_ENV_DECAY:
+            env->level = sustain_level + (env->level - sustain_level) * decay_coeff;
+            if (env->level <= sustain_level + 0.0001f) {
+                env->level = sustain_level;
+                env->stage = NSAW_ENV_SUSTAIN;
+            }
+            break;
+        case NSAW_ENV_SUSTAIN:
+            env->level = sustain_level;
+            break;
+        case NSAW_ENV_RELEASE:
+            /* Ends well above the denormal range, as decay does */
+            env->level *= release_coeff;
+            if (env->level < 0.0001f) {
+                env->level = 0.0f;
+                env->stage = NSAW_ENV_OFF;
+            }
+            break;
+        case NSAW_ENV_OFF:
+        default:
+            env->level = 0.0f;
+            break;
+    }
+}
+
+/* =====================================================================
+ * Silent-voice culling
+ * ===================================================================== */
+
+/* A voice is silent for the coming block if its amp envelope is below the
+ * cull level and cannot rise again without a note-on: decaying toward (or
+ * holding) a sustain below the cull level, or releasing. The amp stage is
+ * applied after the filter, so the SVF tail is inaudible as well. */
+static inline int voice_is_silent(const nsaw_voice_t *v, float amp_sustain) {
+    const nsaw_envelope_t *env = &v->amp_env;
+    if (env->level >= NSAW_CULL_LEVEL) return 0;
+    if (env->stage == NSAW_ENV_RELEASE) return 1;
+    if (env->stage == NSAW_ENV_DECAY || env->stage == NSAW_ENV_SUSTAIN)
+        return amp_sustain < NSAW_CULL_LEVEL;
+    return 0;
+}
+
+/* =====================================================================
+ * Analog drift
+ * ===================================================================== */
+
+/* Advance analog drift across one control sub-block: each oscillator's
+ * drift value at the end of the block (the block ramps to it from
+ * v->drift). Only the `saws` oscillators being rendered drift; the rest
+ * hold. */
+static void update_drift(const nsaw_engine_t *engine, const control_block_t *cb,
+                         nsaw_voice_t *v, int saws, float *drift_end) {
+    uint32_t counter = v->drift_counter++;
+    float a_c = cb->drift_coeff;
+    float scale = cb->drift_noise_scale;
+    for (int j = 0; j < saws; j++) {
+        float noise = drift_noise(counter, v->drift_key + (uint32_t)j * 0x632BE5ABu) * scale;
+        drift_end[j] = v->drift[j] + (noise - v->drift[j]) * a_c;
+    }
+    for (int j = saws; j < engine->num_oscs; j++) drift_end[j] = v->drift[j];
+}
+
+/* =====================================================================
+ * Voice oscillator and post stages
+ * ===================================================================== */
+
+/* Wavetable core, tracked alongside the analytic tiers in voice->aa_tier */
+#define AA_TIER_WAVETABLE NSAW_OSC_QUALITY_COUNT
+
+/* Pick the anti-aliasing tier for a voice */
+static int select_aa_tier(const nsaw_engine_t *engine, const nsaw_voice_t *v) {
+    if (engine->osc_mode == NSAW_OSC_MODE_WAVETABLE) return AA_TIER_WAVETABLE;
+
+    int tier = engine->osc_quality;
+    if (tier == NSAW_OSC_QUALITY_AUTO) {
+        /* Thresholds apply to the frequency relative to the voice's own rate */
+        float f = v->freq * ((float)NSAW_SAMPLE_RATE / (engine->sample_rate * (float)v->os_factor));
+        if (f < NSAW_AUTO_NAIVE_BELOW_HZ) tier = NSAW_OSC_QUALITY_NAIVE;
+        else if (f < NSAW_AUTO_DPW_BELOW_HZ) tier = NSAW_OSC_QUALITY_DPW;
+        else if (f < NSAW_AUTO_POLYBLEP_BELOW_HZ) tier = NSAW_OSC_QUALITY_POLYBLEP;
+        else tier = NSAW_OSC_QUALITY_MINBLEP;
+    }
+
+    /* Under CPU pressure the table-driven tier gives way to PolyBLEP */
+    if (tier == NSAW_OSC_QUALITY_MINBLEP && engine->degrade >= NSAW_DEGRADE_CHEAP_TIERS)
+        tier = NSAW_OSC_QUALITY_POLYBLEP;
+    return tier;
+}
+
+/* Unison level of detail: how many saws (center plus the inner pairs) a
+ * voice renders this block. inc is the center increment at the voice's
+ * internal rate, detune_k the largest detune across the block.
+ *   - pairs whose upper saw is at or above Nyquist only alias
+ *   - a stack whose outer pair beats slower than NSAW_LOD_CLUSTER_HZ is
+ *     coincident; the center pair carries it
+ *   - quiet tails keep only the center pair
+ * The CPU governor thins voices further (NSAW_DEGRADE_*). */
+static int voice_saws(const nsaw_engine_t *engine, const nsaw_voice_t *v,
+                      float inc, float detune_k) {
+    int pairs = engine->num_pairs;
+    const nsaw_envelope_t *env = &v->amp_env;
+    int fading = (env->stage != NSAW_ENV_ATTACK);
+
+    if (engine->unison_lod) {
+        while (pairs > 0 && inc * (1.0f + engine->detune_coeff[2 * pairs - 1] * detune_k) >= 0.5f)
+            pairs--;
+
+        float beat_hz = 2.0f * inc * detune_k * engine->sample_rate * (float)v->os_factor;
+        if (pairs > 1 && beat_hz < NSAW_LOD_CLUSTER_HZ) pairs = 1;
+
+        if (pairs > 1 && fading && env->level < NSAW_LOD_QUIET_LEVEL) pairs = 1;
+    }
+
+    int saws = 2 * pairs + 1;
+    if (engine->degrade >= NSAW_DEGRADE_CAP_SAWS && saws > NSAW_CAPPED_SAWS)
+        saws = NSAW_CAPPED_SAWS;
+    if (engine->degrade >= NSAW_DEGRADE_QUIET_SAWS && saws > NSAW_QUIET_SAWS &&
+        (env->stage == NSAW_ENV_RELEASE || (fading && env->level < NSAW_QUIET_LEVEL)))
+        saws = NSAW_QUIET_SAWS;
+    return saws;
+}
+
+/* Mix normalization correction when only `saws` of the stack sound: keeps
+ * the RMS of the partial stack equal to the full one's */
+static inline float lod_norm_scale(const nsaw_engine_t *engine, int saws, float side_gain) {
+    if (saws >= engine->num_oscs) return 1.0f;
+    float gs2 = side_gain * side_gain;
+    return sqrtf((1.0f + (float)(engine->num_oscs - 1) * gs2) /
+                 (1.0f + (float)(saws - 1) * gs2));
+}
+
+/* Fraction `t` of an LOD fade from a to b (exact at either end) */
+static inline float lod_fade(float a, float b, float t) {
+    if (t <= 0.0f) return a;
+    if (t >= 1.0f) return b;
+    return a + (b - a) * t;
+}
+
+/* Prime DPW state of saws [from, to) from their current phases */
+static void prime_dpw(nsaw_voice_t *v, int from, int to) {
+    for (int j = from; j < to; j++) {
+        float s = 2.0f * v->phase[j] - 1.0f;
+        v->dpw_z[j] = s * s;
+    }
+}
+
+/* Move a voice's phases between float and fixed-point storage (the
+ * fixed-point kernels cover the naive and PolyBLEP tiers only) */
+static void set_phase_fixed(const nsaw_engine_t *engine, nsaw_voice_t *v, int fixed) {
+    if (fixed == v->phase_fixed) return;
+    for (int j = 0; j < engine->num_oscs; j++) {
+        if (fixed) {
+            v->phase_q[j] = (uint32_t)((double)v->phase[j] * NSAW_PHASE_Q_ONE) ^ NSAW_PHASE_Q_HALF;
+        } else {
+            float p = (float)((double)(v->phase_q[j] ^ NSAW_PHASE_Q_HALF) / NSAW_PHASE_Q_ONE);
+            v->phase[j] = (p < 1.0f) ? p : 0.0f;
+        }
+    }
+    v->phase_fixed = fixed;
+}
+
+/* Switch a voice to a new tier, priming that tier's state from the
+ * current phases so the switch is click-free */
+static void enter_aa_tier(const nsaw_engine_t *engine, nsaw_voice_t *v, int tier) {
+    if (tier == NSAW_OSC_QUALITY_DPW) {
+        prime_dpw(v, 0, engine->num_oscs);
+    } else if (tier == NSAW_OSC_QUALITY_MINBLEP) {
+        memset(&v->minblep, 0, sizeof(v->minblep));
+    }
+    v->aa_tier = tier;
+}
+
+/* Per-block oscillator tables: each saw's increment and stereo gains at
+ * the block start plus a per-sample step, padded with zeros to whole
+ * vectors. Everything that shapes them (detune, spread, drift, LOD fades)
+ * moves at control rate, so one linear ramp per block stands in for the
+ * per-sample products. With fixed-point phases the increments ramp as
+ * integers (inc_q) instead. */
+#define OSC_TABLE_SIZE 32   /* NSAW_MAX_OSC_VOICES rounded up to 8 lanes */
+
+typedef struct {
+    float inc[OSC_TABLE_SIZE] NSAW_ALIGNED;
+    float gain_l[OSC_TABLE_SIZE] NSAW_ALIGNED;
+    float gain_r[OSC_TABLE_SIZE] NSAW_ALIGNED;
+    float inc_step[OSC_TABLE_SIZE] NSAW_ALIGNED;
+    float gain_l_step[OSC_TABLE_SIZE] NSAW_ALIGNED;
+    float gain_r_step[OSC_TABLE_SIZE] NSAW_ALIGNED;
+    uint32_t inc_q[OSC_TABLE_SIZE] NSAW_ALIGNED;       /* inc * 2^32 */
+    uint32_t inc_q_step[OSC_TABLE_SIZE] NSAW_ALIGNED;  /* two's complement */
+    int count;      /* saws in the tables */
+    int padded;     /* count rounded up to whole vectors */
+    int fixed;      /* phases in v->phase_q: inc_q is live, inc is not */
+} osc_tables_t;
+
+/* Step every table by one sample */
+static inline void osc_tables_advance(osc_tables_t *t) {
+    for (int j = 0; j < t->padded; j += OB_LANES) {
+        if (t->fixed)
+            ob_storei(t->inc_q + j, ob_addi(ob_loadi(t->inc_q + j), ob_loadi(t->inc_q_step + j)));
+        else
+            ob_store(t->inc + j, ob_add(ob_load(t->inc + j), ob_load(t->inc_step + j)));
+        ob_store(t->gain_l + j, ob_add(ob_load(t->gain_l + j), ob_load(t->gain_l_step + j)));
+        ob_store(t->gain_r + j, ob_add(ob_load(t->gain_r + j), ob_load(t->gain_r_step + j)));
+    }
+}
+
+/* Advance one voice's saw bank by one (internal-rate) sample */
+static inline void tick_saws(const nsaw_engine_t *engine, nsaw_voice_t *v, int tier,
+                             const osc_tables_t *t, float *out_l, float *out_r) {
+    int saws = t->count;
+
+    if (t->fixed) {
+        if (tier == NSAW_OSC_QUALITY_NAIVE)
+            nsaw_osc_bank_tick_naive_q(v->phase_q, t->inc_q, t->gain_l, t->gain_r,
+                                       saws, out_l, out_r);
+        else if (engine->osc_kernel == NSAW_OSC_KERNEL_SCALAR)
+            nsaw_osc_bank_tick_scalar_q(v->phase_q, t->inc_q, t->gain_l, t->gain_r,
+                                        saws, out_l, out_r);
+        else
+            nsaw_osc_bank_tick_q(v->phase_q, t->inc_q, t->gain_l, t->gain_r,
+                                 saws, out_l, out_r);
+        return;
+    }
+
+    switch (tier) {
+        case AA_TIER_WAVETABLE:
+            nsaw_osc_bank_tick_wavetable(v->phase, t->inc, t->gain_l, t->gain_r,
+                                         saws, out_l, out_r);
+            break;
+        case NSAW_OSC_QUALITY_NAIVE:
+            nsaw_osc_bank_tick_naive(v->phase, t->inc, t->gain_l, t->gain_r,
+                                     saws, out_l, out_r);
+            break;
+        case NSAW_OSC_QUALITY_DPW:
+            nsaw_osc_bank_tick_dpw(v->phase, v->dpw_z, t->inc, t->gain_l, t->gain_r,
+                                   saws, out_l, out_r);
+            break;
+        case NSAW_OSC_QUALITY_MINBLEP:
+            nsaw_osc_bank_tick_minblep(v->phase, t->inc, t->gain_l, t->gain_r,
+                                       saws, &v->minblep,
+                                       out_l, out_r);
+            break;
+        case NSAW_OSC_QUALITY_POLYBLEP:
+        default:
+            if (engine->osc_kernel == NSAW_OSC_KERNEL_SCALAR) {
+                nsaw_osc_bank_tick_scalar(v->phase, t->inc, t->gain_l, t->gain_r,
+                                          saws, out_l, out_r);
+            } else {
+                nsaw_osc_bank_tick(v->phase, t->inc, t->gain_l, t->gain_r,
+                                   saws, out_l, out_r);
+            }
+            break;
+    }
+}
+
+/* Advance ramped control values by one output sample */
+static inline void control_step(nsaw_control_t *c, const nsaw_control_t *d) {
+    c->cutoff_hz     += d->cutoff_hz;
+    c->k             += d->k;
+    c->f_env_octaves += d->f_env_octaves;
+    c->detune_k      += d->detune_k;
+    c->side_gain     += d->side_gain;
+    c->norm          += d->norm;
+    c->sub_level     += d->sub_level;
+    c->master_vol    += d->master_vol;
+}
+
+/* Bypassed SVF: park the integrators at the lowpass steady state for the
+ * last input, so the filter comes back in without a step */
+static inline void svf_bypass_state(nsaw_voice_t *v, float x_l, float x_r) {
+    v->ic1eq_l = 0.0f;
+    v->ic2eq_l = x_l;
+    v->ic1eq_r = 0.0f;
+    v->ic2eq_r = x_r;
+}
+
+/* Once per block: DC-blocker and SVF state decaying on silent input */
+static inline void flush_voice_state(nsaw_voice_t *v) {
+    v->hpf_x_prev_l = nsaw_flush_denormal(v->hpf_x_prev_l);
+    v->hpf_y_prev_l = nsaw_flush_denormal(v->hpf_y_prev_l);
+    v->hpf_x_prev_r = nsaw_flush_denormal(v->hpf_x_prev_r);
+    v->hpf_y_prev_r = nsaw_flush_denormal(v->hpf_y_prev_r);
+    v->ic1eq_l = nsaw_flush_denormal(v->ic1eq_l);
+    v->ic2eq_l = nsaw_flush_denormal(v->ic2eq_l);
+    v->ic1eq_r = nsaw_flush_denormal(v->ic1eq_r);
+    v->ic2eq_r = nsaw_flush_denormal(v->ic2eq_r);
+}
+
+/* Count-specialized block kernel for a voice's tier, or NULL to tick per
+ * sample (see nusaw_osc_block.h) */
+static nsaw_osc_block_fn select_osc_block(const nsaw_engine_t *engine, int tier,
+                                          int fixed, int saws) {
+    if (engine->osc_kernel != NSAW_OSC_KERNEL_BLOCK) return NULL;
+    if (tier == NSAW_OSC_QUALITY_NAIVE)
+        return nsaw_osc_block_kernel(fixed ? NSAW_OSC_BLOCK_NAIVE_Q : NSAW_OSC_BLOCK_NAIVE, saws);
+    if (tier == NSAW_OSC_QUALITY_POLYBLEP)
+        return nsaw_osc_block_kernel(fixed ? NSAW_OSC_BLOCK_POLYBLEP_Q : NSAW_OSC_BLOCK_POLYBLEP,
+                                     saws);
+    return NULL;
+}
+
+/* Mix normalization and sub oscillator over a voice's raw saw mix, in
+ * place (the second half of render_voice_osc) */
+template <bool SUB>
+static void osc_finish(nsaw_voice_t *v, const nsaw_control_t *from, const nsaw_control_t *d,
+                       float norm_scale, float norm_scale_step, float sub_cos, float sub_sin,
+                       float *out_l, float *out_r, int stride, int frames, int os) {
+    /* Control values, ramped per sample */
+    nsaw_control_t c = *from;
+    int w = 0;
+
+    for (int n = 0; n < frames; n++) {
+        control_step(&c, d);
+        norm_scale += norm_scale_step;
+
+        for (int s = 0; s < os; s++, w += stride) {
+            /* RMS-based normalization for consistent loudness */
+            float osc_mix_l = out_l[w] * (c.norm * norm_scale);
+            float osc_mix_r = out_r[w] * (c.norm * norm_scale);
+
+            /* --- Sub oscillator (sine, center-panned) --- */
+            if (SUB) {
+                float re = v->sub_re * sub_cos - v->sub_im * sub_sin;
+                float im = v->sub_re * sub_sin + v->sub_im * sub_cos;
+                v->sub_re = re;
+                v->sub_im = im;
+                float sub = im * c.sub_level;
+                osc_mix_l += sub * 0.7071f;  /* center pan */
+                osc_mix_r += sub * 0.7071f;
+            }
+
+            out_l[w] = osc_mix_l;
+            out_r[w] = osc_mix_r;
+        }
+    }
+}
+
+/* Oscillator stage of one voice for one control block: saws, mix
+ * normalization and sub oscillator at the voice's internal rate.
+ * Writes cb->frames * os_factor samples, out[i * stride]. */
+static void render_voice_osc(nsaw_engine_t *engine, nsaw_voice_t *v, const control_block_t *cb,
+                             float bend_ratio, float *out_l, float *out_r, int stride) {
+    const nsaw_control_t *from = &cb->from;
+    const nsaw_control_t *d = &cb->delta;
+    int features = cb->features;
+    int frames = cb->frames;
+    float sr = engine->sample_rate;
+
+    float f0 = v->freq * bend_ratio;
+
+    /* Internal rate: the oscillators run os_factor times per output sample */
+    int os = v->os_factor;
+    float inv_os = 1.0f / (float)os;
+
+    /* Base phase increment (output rate) */
+    float inc0 = f0 / sr;
+
+    /* Sub oscillator increment (octave offset, internal rate) */
+    float sub_mult = (engine->sub_octave == -2) ? 0.25f :
+                     (engine->sub_octave == -1) ? 0.5f : 1.0f;
+    float sub_inc = inc0 * sub_mult * inv_os;
+    int sub_on = (features & FEAT_SUB);
+
+    /* Sub as a complex rotation: the per-sample rotor follows pitch bend
+     * per block. Rotor and phasor are pulled back to unit length (one
+     * Newton step for 1/sqrt each), so neither the sine approximation's
+     * length error nor rounding can accumulate in amplitude beyond a block
+     * (tests/sub_rotation.cpp) */
+    float sub_cos = 1.0f, sub_sin = 0.0f;
+    if (sub_on) {
+        sub_sin = nsaw_sin2pif(sub_inc);
+        sub_cos = nsaw_sin2pif(sub_inc + 0.25f);
+        float rotor2 = sub_cos * sub_cos + sub_sin * sub_sin;
+        float rotor_renorm = 1.5f - 0.5f * rotor2;
+        sub_cos *= rotor_renorm;
+        sub_sin *= rotor_renorm;
+        float mag2 = v->sub_re * v->sub_re + v->sub_im * v->sub_im;
+        float renorm = 1.5f - 0.5f * mag2;
+        v->sub_re *= renorm;
+        v->sub_im *= renorm;
+    }
+
+    /* Saw core / anti-aliasing tier (note frequency based in AUTO) */
+    int tier = select_aa_tier(engine, v);
+
+    /* Unison LOD: a change in saw count fades the pairs in question in or
+     * out across the control block while the normalization ramps to
+     * match. The count is chosen where a control block begins; a block
+     * split across render calls carries on with the fade it started. */
+    int decide = (cb->phase == 0 || v->saws < 0 || v->saws > engine->num_oscs);
+    int saws = v->saws;
+    if (decide) {
+        float detune_max = from->detune_k + d->detune_k * (float)frames;
+        if (detune_max < from->detune_k) detune_max = from->detune_k;
+        saws = voice_saws(engine, v, inc0 * inv_os, detune_max);
+        v->lod_from = (v->saws < 0 || v->saws > engine->num_oscs) ? saws : v->saws;
+    }
+    int prev = v->lod_from;
+    int live = (saws > prev) ? saws : prev;       /* saws ticked this block */
+    int fade_lo = (saws > prev) ? prev : saws;    /* [fade_lo, live) fade */
+    int fade_in = (saws > prev);
+    float fade0 = (float)cb->phase / (float)(cb->phase + cb->ramp);
+    float fade1 = (float)(cb->phase + frames) / (float)(cb->phase + cb->ramp);
+
+    int fixed = (engine->phase_mode == NSAW_PHASE_FIXED &&
+                 (tier == NSAW_OSC_QUALITY_NAIVE || tier == NSAW_OSC_QUALITY_POLYBLEP));
+    set_phase_fixed(engine, v, fixed);
+
+    if (tier != v->aa_tier) enter_aa_tier(engine, v, tier);
+    else if (decide && live > prev && tier == NSAW_OSC_QUALITY_DPW) prime_dpw(v, prev, live);
+    v->saws = saws;
+
+    float norm_prev = lod_norm_scale(engine, prev, from->side_gain);
+    float norm_next = lod_norm_scale(engine, saws, from->side_gain);
+    float norm_scale = lod_fade(norm_prev, norm_next, fade0);
+    float norm_scale_step = (lod_fade(norm_prev, norm_next, fade1) - norm_scale) / (float)frames;
+
+    /* Analog drift (control rate): slow random walk per oscillator
+     * (~0.35 cents), ramped across the block as a pitch multiplier */
+    float drift_end[NSAW_MAX_OSC_VOICES];
+    update_drift(engine, cb, v, live, drift_end);
+
+    /* --- Oscillator tables: block start and end, ramped linearly --- */
+
+    osc_tables_t t;
+    t.count = live;
+    t.fixed = fixed;
+    t.padded = (live + OB_LANES - 1) / OB_LANES * OB_LANES;
+    float inv_frames = 1.0f / (float)frames;
+    float detune0 = from->detune_k;
+    float detune1 = from->detune_k + d->detune_k * (float)frames;
+    float gs0 = from->side_gain;
+    float gs1 = from->side_gain + d->side_gain * (float)frames;
+
+    for (int j = 0; j < live; j++) {
+        /* inc[j] = (inc0 + coeff[j] * inc0 * detune_k) * drift, internal rate */
+        float drift0 = 1.0f + v->drift[j] * DRIFT_AMOUNT;
+        float drift1 = 1.0f + drift_end[j] * DRIFT_AMOUNT;
+        float inc_a = inc0 * (1.0f + engine->detune_coeff[j] * detune0) * drift0 * inv_os;
+        float inc_b = inc0 * (1.0f + engine->detune_coeff[j] * detune1) * drift1 * inv_os;
+        if (inc_a < 0.0f) inc_a = 0.0f;  /* Safety clamp */
+        if (inc_b < 0.0f) inc_b = 0.0f;
+
+        /* Gain (center=1.0, sides=gs) with the LOD fade, folded into pan */
+        float gain_a = (j == 0) ? 1.0f : gs0;
+        float gain_b = (j == 0) ? 1.0f : gs1;
+        if (j >= fade_lo) {
+            gain_a = fade_in ? lod_fade(0.0f, gain_a, fade0) : lod_fade(gain_a, 0.0f, fade0);
+            gain_b = fade_in ? lod_fade(0.0f, gain_b, fade1) : lod_fade(gain_b, 0.0f, fade1);
+        }
+
+        t.inc[j] = inc_a;
+        t.inc_step[j] = (inc_b - inc_a) * inv_frames;
+        if (fixed) {
+            /* Ramp between the clamped ends: stays below 2^31 throughout */
+            uint32_t q_a = nsaw_phase_q_inc(inc_a);
+            uint32_t q_b = nsaw_phase_q_inc(inc_b);
+            t.inc_q[j] = q_a;
+            t.inc_q_step[j] = (uint32_t)(int32_t)((double)((int64_t)q_b - (int64_t)q_a) *
+                                                  (double)inv_frames);
+        }
+        t.gain_l[j] = gain_a * engine->pan_l[j];
+        t.gain_r[j] = gain_a * engine->pan_r[j];
+        t.gain_l_step[j] = (gain_b * engine->pan_l[j] - t.gain_l[j]) * inv_frames;
+        t.gain_r_step[j] = (gain_b * engine->pan_r[j] - t.gain_r[j]) * inv_frames;
+    }
+    for (int j = live; j < t.padded; j++) {
+        t.inc[j] = t.gain_l[j] = t.gain_r[j] = 0.0f;
+        t.inc_step[j] = t.gain_l_step[j] = t.gain_r_step[j] = 0.0f;
+        t.inc_q[j] = t.inc_q_step[j] = 0;
+    }
+    for (int j = 0; j < engine->num_oscs; j++) v->drift[j] = drift_end[j];
+
+    /* --- Generate and mix all oscillator voices (stereo, raw) --- */
+
+    nsaw_osc_block_fn block = select_osc_block(engine, tier, fixed, live);
+    if (block) {
+        nsaw_osc_block_args_t a = {
+            v->phase, v->phase_q,
+            t.inc, t.inc_step, t.inc_q, t.inc_q_step,
+            t.gain_l, t.gain_l_step, t.gain_r, t.gain_r_step
+        };
+        block(&a, frames, os, out_l, out_r, stride);
+    } else {
+        int w = 0;
+        for (int n = 0; n < frames; n++) {
+            osc_tables_advance(&t);
+            for (int s = 0; s < os; s++, w += stride)
+                tick_saws(engine, v, tier, &t, &out_l[w], &out_r[w]);
+        }
+    }
+
+    if (sub_on)
+        osc_finish<true>(v, from, d, norm_scale, norm_scale_step, sub_cos, sub_sin,
+                         out_l, out_r, stride, frames, os);
+    else
+        osc_finish<false>(v, from, d, norm_scale, norm_scale_step, sub_cos, sub_sin,
+                          out_l, out_r, stride, frames, os);
+}
+
+/* Scalar post stage of one voice for one control block: DC-blocking HPF
+ * and SVF at the voice's internal rate, decimation, then envelopes and amp
+ * at the output rate. Reads frames * os_factor samples of oscillator mix
+ * and accumulates into the output buffers. FEAT selects the filter
+ * stages (FEAT_FILTER, FEAT_FILTER_MOD). */
+template <int FEAT>
+static void render_voice_post(nsaw_engine_t *engine, nsaw_voice_t *v,
+                              const nsaw_control_t *from, const nsaw_control_t *d,
+                              const env_coeffs_t *ec, const float *in_l, const float *in_r,
+                              float *out_left, float *out_right, int frames) {
+    float vel_gain = 1.0f - engine->vel_sens + engine->vel_sens * v->velocity;
+
+    int os = v->os_factor;
+    float sr_os = engine->sample_rate * (float)os;
+    float hpf_r = engine->hpf_coeff;
+    float hpf_coeff = (os == 1) ? hpf_r : (os == 2) ? sqrtf(hpf_r) : sqrtf(sqrtf(hpf_r));
+
+    /* Block-constant SVF coefficients at this voice's rate */
+    float fc_max = svf_max_cutoff(sr_os);
+    svf_coeffs_t svf = { 0.0f, 0.0f, 0.0f };
+    if ((FEAT & FEAT_FILTER) && !(FEAT & FEAT_FILTER_MOD)) {
+        float fc = from->cutoff_hz;
+        if (fc > fc_max) fc = fc_max;
+        if (fc < NSAW_SVF_MIN_HZ) fc = NSAW_SVF_MIN_HZ;
+        svf_coeffs(fc, from->k, sr_os, &svf);
+    }
+
+    /* Control values, ramped per sample */
+    nsaw_control_t c = *from;
+
+    for (int n = 0; n < frames; n++) {
+        control_step(&c, d);
+
+        /* --- Process envelopes (output rate) --- */
+
+        process_envelope(&v->amp_env, ec->amp_attack_rate, ec->amp_decay_coeff,
+                       ec->amp_sustain, ec->amp_release_coeff);
+        process_envelope(&v->filt_env, ec->filt_attack_rate, ec->filt_decay_coeff,
+                       ec->filt_sustain, ec->filt_release_coeff);
+
+        /* --- Resonant lowpass filter with envelope modulation (stereo) --- */
+
+        float a1 = svf.a1, a2 = svf.a2, a3 = svf.a3;
+        if (FEAT & FEAT_FILTER_MOD) {
+            float mod_cutoff_hz = c.cutoff_hz * nsaw_exp2f(v->filt_env.level * c.f_env_octaves);
+            if (mod_cutoff_hz > fc_max) mod_cutoff_hz = fc_max;
+            if (mod_cutoff_hz < NSAW_SVF_MIN_HZ) mod_cutoff_hz = NSAW_SVF_MIN_HZ;
+
+            /* TPT/SVF coefficients (shared between L and R, held across sub-samples) */
+            float g = nsaw_tanf((float)M_PI * mod_cutoff_hz / sr_os);
+            a1 = 1.0f / (1.0f + g * (g + c.k));
+            a2 = g * a1;
+            a3 = g * a2;
+        }
+
+        /* --- Internal-rate path: HPF, SVF --- */
+
+        float os_l[NSAW_MAX_OVERSAMPLE];
+        float os_r[NSAW_MAX_OVERSAMPLE];
+
+        for (int s = 0; s < os; s++) {
+            float osc_mix_l = in_l[n * os + s];
+            float osc_mix_r = in_r[n * os + s];
+
+            /* --- Post-mix DC-blocking HPF (stereo) ---
+             * y[n] = x[n] - x[n-1] + R * y[n-1]
+             * 1-pole highpass, cutoff ~20Hz */
+            float hpf_l = osc_mix_l - v->hpf_x_prev_l + hpf_coeff * v->hpf_y_prev_l;
+            v->hpf_x_prev_l = osc_mix_l;
+            v->hpf_y_prev_l = hpf_l;
+
+            float hpf_r = osc_mix_r - v->hpf_x_prev_r + hpf_coeff * v->hpf_y_prev_r;
+            v->hpf_x_prev_r = osc_mix_r;
+            v->hpf_y_prev_r = hpf_r;
+
+            if (!(FEAT & FEAT_FILTER)) {
+                os_l[s] = hpf_l;
+                os_r[s] = hpf_r;
+                continue;
+            }
+
+            /* L channel SVF */
+            float t3_l = hpf_l - v->ic2eq_l;
+            float t1_l = a1 * v->ic1eq_l + a2 * t3_l;
+            float t2_l = v->ic2eq_l + a2 * v->ic1eq_l + a3 * t3_l;
+            v->ic1eq_l = 2.0f * t1_l - v->ic1eq_l;
+            v->ic2eq_l = 2.0f * t2_l - v->ic2eq_l;
+
+            /* R channel SVF */
+            float t3_r = hpf_r - v->ic2eq_r;
+            float t1_r = a1 * v->ic1eq_r + a2 * t3_r;
+            float t2_r = v->ic2eq_r + a2 * v->ic1eq_r + a3 * t3_r;
+            v->ic1eq_r = 2.0f * t1_r - v->ic1eq_r;
+            v->ic2eq_r = 2.0f * t2_r - v->ic2eq_r;
+
+            os_l[s] = t2_l;
+            os_r[s] = t2_r;
+        }
+
+        /* --- Decimate back to the output rate --- */
+
+        float y_l, y_r;
+        if (os == 1) {
+            y_l = os_l[0];
+            y_r = os_r[0];
+        } else if (os == 2) {
+            y_l = nsaw_halfband_decimate(&v->dec_l[0], os_l[0], os_l[1]);
+            y_r = nsaw_halfband_decimate(&v->dec_r[0], os_r[0], os_r[1]);
+        } else {
+            float m0_l = nsaw_halfband_decimate(&v->dec_l[0], os_l[0], os_l[1]);
+            float m1_l = nsaw_halfband_decimate(&v->dec_l[0], os_l[2], os_l[3]);
+            float m0_r = nsaw_halfband_decimate(&v->dec_r[0], os_r[0], os_r[1]);
+            float m1_r = nsaw_halfband_decimate(&v->dec_r[0], os_r[2], os_r[3]);
+            y_l = nsaw_halfband_decimate(&v->dec_l[1], m0_l, m1_l);
+            y_r = nsaw_halfband_decimate(&v->dec_r[1], m0_r, m1_r);
+        }
+
+        /* --- Apply amp envelope and velocity --- */
+
+        float amp = v->amp_env.level * vel_gain * c.master_vol;
+        out_left[n]  += y_l * amp;
+        out_right[n] += y_r * amp;
+    }
+
+    if (!(FEAT & FEAT_FILTER)) svf_bypass_state(v, v->hpf_y_prev_l, v->hpf_y_prev_r);
+    flush_voice_state(v);
+}
+
+/* =====================================================================
+ * Voice-lane post stage
+ *
+ * The render_voice_post path (output-rate voices only) for OB_LANES
+ * voices at once, one voice per lane: envelopes, cutoff modulation, HPF,
+ * SVF and amp are each one vector operation per sample. Envelope stage
+ * changes are lane masks instead of the per-voice switch.
+ * ===================================================================== */
+
+/* Fast-math kernels across a lane vector: 4-lane kernels directly, per
+ * half for 8 lanes, libm per lane for NSAW_USE_LIBM reference renders */
+#if defined(NSAW_USE_LIBM)
+#define LANE_MATH(name, scalar, v4)                                   \
+    static inline ob_vf name(ob_vf x) {                               \
+        float t[OB_LANES] NSAW_ALIGNED;                               \
+        ob_store(t, x);                                               \
+        for (int i = 0; i < OB_LANES; i++) t[i] = scalar(t[i]);       \
+        return ob_load(t);                                            \
+    }
+#elif OB_LANES == 8
+#define LANE_MATH(name, scalar, v4)                                   \
+    static inline ob_vf name(ob_vf x) {                               \
+        return nsaw_f8_join(v4(nsaw_f8_lo(x)), v4(nsaw_f8_hi(x)));    \
+    }
+#else
+#define LANE_MATH(name, scalar, v4)                                   \
+    static inline ob_vf name(ob_vf x) { return v4(x); }
+#endif
+
+LANE_MATH(lane_exp2, nsaw_exp2f, nsaw_fast_exp2_v4)
+LANE_MATH(lane_tan, nsaw_tanf, nsaw_fast_tan_v4)
+
+/* process_envelope() across lanes; stage holds nsaw_env_stage_t as float */
+static inline void lane_envelope(ob_vf *level, ob_vf *stage, ob_vf attack_rate,
+                                 ob_vf decay_coeff, ob_vf sustain, ob_vf release_coeff) {
+    const ob_vf zero = ob_set1(0.0f);
+    const ob_vf one = ob_set1(1.0f);
+    const ob_vf floor_ = ob_set1(0.0001f);
+    ob_vf lv = *level;
+    ob_vf st = *stage;
+
+    ob_vm is_att = ob_eq(st, ob_set1((float)NSAW_ENV_ATTACK));
+    ob_vm is_dec = ob_eq(st, ob_set1((float)NSAW_ENV_DECAY));
+    ob_vm is_sus = ob_eq(st, ob_set1((float)NSAW_ENV_SUSTAIN));
+    ob_vm is_rel = ob_eq(st, ob_set1((float)NSAW_ENV_RELEASE));
+
+    ob_vf att = ob_add(lv, attack_rate);
+    ob_vm att_done = ob_ge(att, one);
+    att = ob_min(att, one);
+
+    ob_vf dec = ob_add(sustain, ob_mul(ob_sub(lv, sustain), decay_coeff));
+    ob_vm dec_done = ob_ge(ob_add(sustain, floor_), dec);
+    dec = ob_select(dec_done, sustain, dec);
+
+    ob_vf rel = ob_mul(lv, release_coeff);
+    ob_vm rel_done = ob_lt(rel, floor_);
+    rel = ob_select(rel_done, zero, rel);
+
+    lv = ob_select(is_att, att,
+         ob_select(is_dec, dec,
+         ob_select(is_sus, sustain,
+         ob_select(is_rel, rel, zero))));
+
+    st = ob_select(ob_and(is_att, att_done), ob_set1((float)NSAW_ENV_DECAY), st);
+    st = ob_select(ob_and(is_dec, dec_done), ob_set1((float)NSAW_ENV_SUSTAIN), st);
+    st = ob_select(ob_and(is_rel, rel_done), ob_set1((float)NSAW_ENV_OFF), st);
+
+    *level = lv;
+    *stage = st;
+}
+
+/* Lane state gathered from / scattered to the voices */
+enum {
+    LV_HPF_X_L, LV_HPF_Y_L, LV_HPF_X_R, LV_HPF_Y_R,
+    LV_IC1_L, LV_IC2_L, LV_IC1_R, LV_IC2_R,
+    LV_AMP, LV_AMP_STAGE, LV_FILT, LV_FILT_STAGE, LV_VEL,
+    LV_COUNT
+};
+
+/* Post stage for `count` (<= OB_LANES) output-rate voices. Input is
+ * in[n * stride + lane]; unused lanes must hold zeros. FEAT as for
+ * render_voice_post; svf holds the block-constant coefficients. */
+template <int FEAT>
+static void render_lanes_post(nsaw_engine_t *engine, nsaw_voice_t *const *voices, int count,
+                              const nsaw_control_t *from, const nsaw_control_t *d,
+                              const svf_coeffs_t *svf, const env_coeffs_t *ec,
+                              const float *in_l, const float *in_r,
+                              int stride, float *out_left, float *out_right, int frames) {
+    float st[LV_COUNT][OB_LANES] NSAW_ALIGNED;
+
+    /* Gather (unused lanes: silent, envelope off) */
+    for (int i = 0; i < OB_LANES; i++) {
+        for (int k = 0; k < LV_COUNT; k++) st[k][i] = 0.0f;
+        if (i >= count) continue;
+        const nsaw_voice_t *v = voices[i];
+        st[LV_HPF_X_L][i] = v->hpf_x_prev_l;
+        st[LV_HPF_Y_L][i] = v->hpf_y_prev_l;
+        st[LV_HPF_X_R][i] = v->hpf_x_prev_r;
+        st[LV_HPF_Y_R][i] = v->hpf_y_prev_r;
+        st[LV_IC1_L][i] = v->ic1eq_l;
+        st[LV_IC2_L][i] = v->ic2eq_l;
+        st[LV_IC1_R][i] = v->ic1eq_r;
+        st[LV_IC2_R][i] = v->ic2eq_r;
+        st[LV_AMP][i] = v->amp_env.level;
+        st[LV_AMP_STAGE][i] = (float)v->amp_env.stage;
+        st[LV_FILT][i] = v->filt_env.level;
+        st[LV_FILT_STAGE][i] = (float)v->filt_env.stage;
+        st[LV_VEL][i] = 1.0f - engine->vel_sens + engine->vel_sens * v->velocity;
+    }
+
+    ob_vf hpf_x_l = ob_load(st[LV_HPF_X_L]), hpf_y_l = ob_load(st[LV_HPF_Y_L]);
+    ob_vf hpf_x_r = ob_load(st[LV_HPF_X_R]), hpf_y_r = ob_load(st[LV_HPF_Y_R]);
+    ob_vf ic1_l = ob_load(st[LV_IC1_L]), ic2_l = ob_load(st[LV_IC2_L]);
+    ob_vf ic1_r = ob_load(st[LV_IC1_R]), ic2_r = ob_load(st[LV_IC2_R]);
+    ob_vf amp_lv = ob_load(st[LV_AMP]), amp_st = ob_load(st[LV_AMP_STAGE]);
+    ob_vf flt_lv = ob_load(st[LV_FILT]), flt_st = ob_load(st[LV_FILT_STAGE]);
+    const ob_vf vel = ob_load(st[LV_VEL]);
+
+    const ob_vf amp_ar = ob_set1(ec->amp_attack_rate), amp_dc = ob_set1(ec->amp_decay_coeff);
+    const ob_vf amp_s = ob_set1(ec->amp_sustain), amp_rc = ob_set1(ec->amp_release_coeff);
+    const ob_vf flt_ar = ob_set1(ec->filt_attack_rate), flt_dc = ob_set1(ec->filt_decay_coeff);
+    const ob_vf flt_s = ob_set1(ec->filt_sustain), flt_rc = ob_set1(ec->filt_release_coeff);
+    const ob_vf one = ob_set1(1.0f);
+    const ob_vf two = ob_set1(2.0f);
+    const ob_vf hpf_r = ob_set1(engine->hpf_coeff);
+    const ob_vf fc_min = ob_set1(NSAW_SVF_MIN_HZ);
+    const ob_vf fc_max = ob_set1(svf_max_cutoff(engine->sample_rate));
+    const ob_vf pi_sr = ob_set1((float)M_PI / engine->sample_rate);
+    const ob_vf svf_a1 = ob_set1(svf->a1);
+    const ob_vf svf_a2 = ob_set1(svf->a2);
+    const ob_vf svf_a3 = ob_set1(svf->a3);
+
+    /* Control values, ramped per sample */
+    nsaw_control_t c = *from;
+
+    for (int n = 0; n < frames; n++) {
+        control_step(&c, d);
+
+        /* --- Envelopes --- */
+        lane_envelope(&amp_lv, &amp_st, amp_ar, amp_dc, amp_s, amp_rc);
+        lane_envelope(&flt_lv, &flt_st, flt_ar, flt_dc, flt_s, flt_rc);
+
+        /* --- Cutoff modulation and TPT/SVF coefficients --- */
+        ob_vf a1 = svf_a1, a2 = svf_a2, a3 = svf_a3;
+        if (FEAT & FEAT_FILTER_MOD) {
+            ob_vf fc = ob_mul(ob_set1(c.cutoff_hz),
+                              lane_exp2(ob_mul(flt_lv, ob_set1(c.f_env_octaves))));
+            fc = ob_max(ob_min(fc, fc_max), fc_min);
+            ob_vf g = lane_tan(ob_mul(pi_sr, fc));
+            a1 = ob_div(one, ob_add(one, ob_mul(g, ob_add(g, ob_set1(c.k)))));
+            a2 = ob_mul(g, a1);
+            a3 = ob_mul(g, a2);
+        }
+
+        /* --- DC-blocking HPF --- */
+        ob_vf x_l = ob_load(in_l + n * stride);
+        ob_vf x_r = ob_load(in_r + n * stride);
+        ob_vf h_l = ob_add(ob_sub(x_l, hpf_x_l), ob_mul(hpf_r, hpf_y_l));
+        ob_vf h_r = ob_add(ob_sub(x_r, hpf_x_r), ob_mul(hpf_r, hpf_y_r));
+        hpf_x_l = x_l; hpf_y_l = h_l;
+        hpf_x_r = x_r; hpf_y_r = h_r;
+
+        if (!(FEAT & FEAT_FILTER)) {
+            ob_vf amp = ob_mul(ob_mul(amp_lv, vel), ob_set1(c.master_vol));
+            out_left[n]  += ob_hsum(ob_mul(h_l, amp));
+            out_right[n] += ob_hsum(ob_mul(h_r, amp));
+            continue;
+        }
+
+        /* --- SVF (L) --- */
+        ob_vf t3_l = ob_sub(h_l, ic2_l);
+        ob_vf t1_l = ob_add(ob_mul(a1, ic1_l), ob_mul(a2, t3_l));
+        ob_vf t2_l = ob_add(ob_add(ic2_l, ob_mul(a2, ic1_l)), ob_mul(a3, t3_l));
+        ic1_l = ob_sub(ob_mul(two, t1_l), ic1_l);
+        ic2_l = ob_sub(ob_mul(two, t2_l), ic2_l);
+
+        /* --- SVF (R) --- */
+        ob_vf t3_r = ob_sub(h_r, ic2_r);
+        ob_vf t1_r = ob_add(ob_mul(a1, ic1_r), ob_mul(a2, t3_r));
+        ob_vf t2_r = ob_add(ob_add(ic2_r, ob_mul(a2, ic1_r)), ob_mul(a3, t3_r));
+        ic1_r = ob_sub(ob_mul(two, t1_r), ic1_r);
+        ic2_r = ob_sub(ob_mul(two, t2_r), ic2_r);
+
+        /* --- Amp envelope, velocity, sum across voices --- */
+        ob_vf amp = ob_mul(ob_mul(amp_lv, vel), ob_set1(c.master_vol));
+        out_left[n]  += ob_hsum(ob_mul(t2_l, amp));
+        out_right[n] += ob_hsum(ob_mul(t2_r, amp));
+    }
+
+    /* Scatter */
+    ob_store(st[LV_HPF_X_L], hpf_x_l); ob_store(st[LV_HPF_Y_L], hpf_y_l);
+    ob_store(st[LV_HPF_X_R], hpf_x_r); ob_store(st[LV_HPF_Y_R], hpf_y_r);
+    ob_store(st[LV_IC1_L], ic1_l); ob_store(st[LV_IC2_L], ic2_l);
+    ob_store(st[LV_IC1_R], ic1_r); ob_store(st[LV_IC2_R], ic2_r);
+    ob_store(st[LV_AMP], amp_lv); ob_store(st[LV_AMP_STAGE], amp_st);
+    ob_store(st[LV_FILT], flt_lv); ob_store(st[LV_FILT_STAGE], flt_st);
+
+    for (int i = 0; i < count; i++) {
+        nsaw_voice_t *v = voices[i];
+        v->hpf_x_prev_l = st[LV_HPF_X_L][i];
+        v->hpf_y_prev_l = st[LV_HPF_Y_L][i];
+        v->hpf_x_prev_r = st[LV_HPF_X_R][i];
+        v->hpf_y_prev_r = st[LV_HPF_Y_R][i];
+        v->ic1eq_l = st[LV_IC1_L][i];
+        v->ic2eq_l = st[LV_IC2_L][i];
+        v->ic1eq_r = st[LV_IC1_R][i];
+        v->ic2eq_r = st[LV_IC2_R][i];
+        v->amp_env.level = st[LV_AMP][i];
+        v->amp_env.stage = (nsaw_env_stage_t)(int)st[LV_AMP_STAGE][i];
+        v->filt_env.level = st[LV_FILT][i];
+        v->filt_env.stage = (nsaw_env_stage_t)(int)st[LV_FILT_STAGE][i];
+        if (!(FEAT & FEAT_FILTER)) svf_bypass_state(v, v->hpf_y_prev_l, v->hpf_y_prev_r);
+        flush_voice_state(v);
+    }
+}
+
+/* =====================================================================
+ * Voice set rendering
+ * ===================================================================== */
+
+/* Post-stage kernel specializations by the block's filter features */
+typedef void (*voice_post_fn)(nsaw_engine_t *, nsaw_voice_t *,
+                              const nsaw_control_t *, const nsaw_control_t *,
+                              const env_coeffs_t *, const float *, const float *,
+                              float *, float *, int);
+
+static voice_post_fn select_voice_post(int features) {
+    if (!(features & FEAT_FILTER)) return render_voice_post<0>;
+    if (!(features & FEAT_FILTER_MOD)) return render_voice_post<FEAT_FILTER>;
+    return render_voice_post<FEAT_FILTER | FEAT_FILTER_MOD>;
+}
+
+typedef void (*lanes_post_fn)(nsaw_engine_t *, nsaw_voice_t *const *, int,
+                              const nsaw_control_t *, const nsaw_control_t *,
+                              const svf_coeffs_t *, const env_coeffs_t *,
+                              const float *, const float *,
+                              int, float *, float *, int);
+
+static lanes_post_fn select_lanes_post(int features) {
+    if (!(features & FEAT_FILTER)) return render_lanes_post<0>;
+    if (!(features & FEAT_FILTER_MOD)) return render_lanes_post<FEAT_FILTER>;
+    return render_lanes_post<FEAT_FILTER | FEAT_FILTER_MOD>;
+}
+
+/* Render a set of voices through every control sub-block of the plan,
+ * accumulating into out_left/out_right. Voices touch only their own state
+ * and the given scratch, so disjoint sets can render concurrently.
+ * Returns how many of the voices were culled in the last sub-block. */
+static int render_voices(nsaw_engine_t *engine, const render_plan_t *plan,
+                         nsaw_voice_t *const *voices, int count,
+                         nsaw_render_scratch_t *scratch,
+                         float *out_left, float *out_right) {
+    const env_coeffs_t *ec = &plan->ec;
+    int culled = 0;
+    /* Lane buffer row length: this set's voices, padded to whole groups,
+     * so small polyphony touches only the rows' used cache lines */
+    int stride = (count + OB_LANES - 1) / OB_LANES * OB_LANES;
+
+    for (int b = 0; b < plan->num_blocks; b++) {
+        const control_block_t *cb = &plan->blocks[b];
+        int start = cb->start;
+        int n = cb->frames;
+
+        culled = 0;
+        nsaw_voice_t *lane_voices[NSAW_MAX_VOICES];
+        int lanes = 0;
+        for (int vi = 0; vi < count; vi++) {
+            nsaw_voice_t *v = voices[vi];
+            if (v->amp_env.stage == NSAW_ENV_OFF) continue;  /* released mid-call */
+
+            /* Silent voices only advance their envelopes, so a sustain
+             * change or release is tracked and rendering resumes as soon
+             * as the voice could be heard again */
+            v->culled = voice_is_silent(v, ec->amp_sustain);
+            if (v->culled) {
+                for (int i = 0; i < n; i++) {
+                    process_envelope(&v->amp_env, ec->amp_attack_rate, ec->amp_decay_coeff,
+                                     ec->amp_sustain, ec->amp_release_coeff);
+                    process_envelope(&v->filt_env, ec->filt_attack_rate, ec->filt_decay_coeff,
+                                     ec->filt_sustain, ec->filt_release_coeff);
+                }
+                culled++;
+                continue;
+            }
+
+            /* Output-rate voices: oscillators now, post stage in lanes below */
+            if (v->os_factor == 1) {
+                render_voice_osc(engine, v, cb, plan->bend_ratio,
+                                 scratch->lane_buf_l + lanes, scratch->lane_buf_r + lanes, stride);
+                lane_voices[lanes++] = v;
+                continue;
+            }
+
+            render_voice_osc(engine, v, cb, plan->bend_ratio,
+                             scratch->osc_buf_l, scratch->osc_buf_r, 1);
+            select_voice_post(cb->features)(engine, v, &cb->from, &cb->delta, ec,
+                              scratch->osc_buf_l, scratch->osc_buf_r,
+                              out_left + start, out_right + start, n);
+        }
+
+        /* --- Voice-lane post stage (HPF, envelopes, SVF, amp) --- */
+
+        if (lanes > 0) {
+            /* Unused lanes of the last group are silent */
+            int padded = (lanes + OB_LANES - 1) / OB_LANES * OB_LANES;
+            for (int i = 0; i < n; i++) {
+                for (int l = lanes; l < padded; l++) {
+                    scratch->lane_buf_l[i * stride + l] = 0.0f;
+                    scratch->lane_buf_r[i * stride + l] = 0.0f;
+                }
+            }
+            lanes_post_fn lanes_post = select_lanes_post(cb->features);
+            for (int g = 0; g < lanes; g += OB_LANES) {
+                int group = lanes - g;
+                if (group > OB_LANES) group = OB_LANES;
+                lanes_post(engine, lane_voices + g, group, &cb->from, &cb->delta, &cb->svf, ec,
+                                  scratch->lane_buf_l + g, scratch->lane_buf_r + g,
+                                  stride, out_left + start, out_right + start, n);
+            }
+        }
+    }
+    return culled;
+}
+
+/* =====================================================================
+ * Output stage
+ * ===================================================================== */
+
+/* Scale, clamp and interleave a stereo block into int16. The vector loop
+ * clamps before truncating, which gives the same samples as the scalar
+ * tail's truncate-then-clamp. */
+static void write_int16_interleaved(const float *left, const float *right,
+                                    int16_t *out, int frames) {
+    const nsaw_f4 scale = nsaw_f4_set1(32767.0f);
+    const nsaw_f4 lo = nsaw_f4_set1(-32768.0f);
+    const nsaw_f4 hi = nsaw_f4_set1(32767.0f);
+    int i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        int32_t sl[4], sr[4];
+        nsaw_f4 l = nsaw_f4_mul(nsaw_f4_load(left + i), scale);
+        nsaw_f4 r = nsaw_f4_mul(nsaw_f4_load(right + i), scale);
+        nsaw_i4_store_s(sl, nsaw_f4_to_i4(nsaw_f4_min(nsaw_f4_max(l, lo), hi)));
+        nsaw_i4_store_s(sr, nsaw_f4_to_i4(nsaw_f4_min(nsaw_f4_max(r, lo), hi)));
+        for (int k = 0; k < 4; k++) {
+            out[(i + k) * 2]     = (int16_t)sl[k];
+            out[(i + k) * 2 + 1] = (int16_t)sr[k];
+        }
+    }
+    for (; i < frames; i++) {
+        int32_t sl = (int32_t)(left[i] * 32767.0f);
+        int32_t sr = (int32_t)(right[i] * 32767.0f);
+        if (sl > 32767) sl = 32767;
+        if (sl < -32768) sl = -32768;
+        if (sr > 32767) sr = 32767;
+        if (sr < -32768) sr = -32768;
+        out[i * 2]     = (int16_t)sl;
+        out[i * 2 + 1] = (int16_t)sr;
+    }
+}
+
+static void output_stage(float *left, float *right, float threshold,
+                         int16_t *out, int frames) {
+    nsaw_soft_clip_block(left, frames, threshold);
+    nsaw_soft_clip_block(right, frames, threshold);
+    write_int16_interleaved(left, right, out, frames);
+}
+
+/* =====================================================================
+ * Kernel table
+ * ===================================================================== */
+
+#if defined(NSAW_SIMD_SCALAR)
+#define NSAW_KERNELS_NAME "scalar"
+#elif defined(__AVX512F__)
+#define NSAW_KERNELS_NAME "avx512"
+#elif defined(__AVX2__)
+#define NSAW_KERNELS_NAME "avx2"
+#elif defined(NSAW_SIMD_AVX)
+#define NSAW_KERNELS_NAME "avx"
+#elif defined(NSAW_SIMD_SSE)
+#define NSAW_KERNELS_NAME "sse2"
+#elif defined(__ARM_FEATURE_DOTPROD)
+#define NSAW_KERNELS_NAME "armv8.2-a"
+#else
+#define NSAW_KERNELS_NAME "armv8-a"
+#endif
+
+extern const nsaw_kernels_t NSAW_KERNELS_TABLE(NSAW_KERNELS_ISA) = {
+    NSAW_KERNELS_NAME,
+    render_voices,
+    output_stage,
+};
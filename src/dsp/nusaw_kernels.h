@@ -0,0 +1,122 @@
+/*
+ * nusaw_kernels.h - Per-ISA render kernels and their dispatch table
+ *
+ * nusaw_engine.cpp plans a render call (control blocks, envelope
+ * coefficients, worker jobs); nusaw_kernels.cpp runs it per voice and
+ * sample, and also holds the plugin's output stage. nusaw_kernels.cpp is
+ * compiled once per ISA level (scripts/build.sh) and each build exports
+ * one nsaw_kernels_t table:
+ *
+ *   nsaw_kernels_base    always linked (armv8-a, SSE2 or scalar)
+ *   nsaw_kernels_armv82  armv8.2-a + fp16 + dotprod
+ *   nsaw_kernels_avx2    AVX2
+ *   nsaw_kernels_avx512  AVX-512F/VL (8-lane kernels, 32 registers)
+ *
+ * The variants are weak references: a dsp.so built without one simply
+ * does not offer it. nsaw_kernels_select() picks the best table the CPU
+ * supports (the plugin does this once in move_plugin_init_v2).
+ */
+
+#ifndef NUSAW_KERNELS_H
+#define NUSAW_KERNELS_H
+
+#include "nusaw_engine.h"
+#include "nusaw_fastmath.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Per-block voice features (control_block_t.features): the stages a
+ * block's voices need. Each combination has its own compile-time
+ * specialized kernel, so stages that are off cost no tests per sample. */
+#define FEAT_SUB        (1 << 0)    /* Sub oscillator audible */
+#define FEAT_FILTER     (1 << 1)    /* SVF runs (else bypassed, NSAW_FILTER_OPEN_*) */
+#define FEAT_FILTER_MOD (1 << 2)    /* SVF coefficients move within the block */
+
+/* TPT/SVF coefficients */
+typedef struct {
+    float a1, a2, a3;
+} svf_coeffs_t;
+
+/* SVF cutoff range. The top is 20 kHz, or NSAW_SVF_MAX_RATIO of the rate
+ * the filter runs at if that is lower: past Nyquist the SVF is unstable,
+ * and the prewarp stays inside nsaw_fast_tan's range (pi * 0.46 < 1.50).
+ * 0.46 leaves 20 kHz itself in range at 44.1 kHz. */
+#define NSAW_SVF_MIN_HZ 20.0f
+#define NSAW_SVF_MAX_HZ 20000.0f
+#define NSAW_SVF_MAX_RATIO 0.46f
+
+static inline float svf_max_cutoff(float sr) {
+    float fc = NSAW_SVF_MAX_RATIO * sr;
+    return (fc < NSAW_SVF_MAX_HZ) ? fc : NSAW_SVF_MAX_HZ;
+}
+
+static inline void svf_coeffs(float cutoff_hz, float k, float sr, svf_coeffs_t *s) {
+    float g = nsaw_tanf((float)M_PI * cutoff_hz / sr);
+    s->a1 = 1.0f / (1.0f + g * (g + k));
+    s->a2 = g * s->a1;
+    s->a3 = g * s->a2;
+}
+
+/* Envelope coefficients, shared by all voices for one render call */
+typedef struct {
+    float amp_attack_rate, amp_decay_coeff, amp_sustain, amp_release_coeff;
+    float filt_attack_rate, filt_decay_coeff, filt_sustain, filt_release_coeff;
+} env_coeffs_t;
+
+/* One control sub-block of a render call: a control block, or the part
+ * of one that falls inside the call (phase > 0 or frames < ramp) */
+typedef struct {
+    int start, frames;
+    int phase;              /* Frames of this control block rendered by earlier calls */
+    int ramp;               /* Frames to the control block's end */
+    nsaw_control_t from;    /* Control values at the block start */
+    nsaw_control_t delta;   /* Per-sample ramp toward the control block's end */
+    int features;           /* FEAT_* */
+    svf_coeffs_t svf;       /* Output-rate SVF coefficients unless FEAT_FILTER_MOD */
+    float drift_coeff;      /* Drift step over `frames` (see nsaw_engine_set_control_block) */
+    float drift_noise_scale;
+} control_block_t;
+
+/* A span may start and end part way through a control block */
+#define MAX_CONTROL_BLOCKS (NSAW_MAX_RENDER / NSAW_MIN_CONTROL_BLOCK + 1)
+
+/* Everything a voice needs for one render call; shared read-only by jobs */
+typedef struct {
+    env_coeffs_t ec;
+    float bend_ratio;
+    int frames;
+    int num_blocks;
+    control_block_t blocks[MAX_CONTROL_BLOCKS];
+} render_plan_t;
+
+/* Render kernels of one ISA build */
+struct nsaw_kernels {
+    const char *name;
+
+    /* Render a set of voices through every control sub-block of the plan,
+     * accumulating into out_left/out_right. Voices touch only their own
+     * state and the given scratch, so disjoint sets can render
+     * concurrently. Returns how many were culled in the last sub-block. */
+    int (*render_voices)(nsaw_engine_t *engine, const render_plan_t *plan,
+                         nsaw_voice_t *const *voices, int count,
+                         nsaw_render_scratch_t *scratch,
+                         float *out_left, float *out_right);
+
+    /* Soft clip a stereo block in place (tanh above +/-threshold), then
+     * convert it to interleaved int16 */
+    void (*output)(float *left, float *right, float threshold,
+                   int16_t *out, int frames);
+};
+
+extern const nsaw_kernels_t nsaw_kernels_base;
+extern const nsaw_kernels_t nsaw_kernels_armv82 __attribute__((weak));
+extern const nsaw_kernels_t nsaw_kernels_avx2 __attribute__((weak));
+extern const nsaw_kernels_t nsaw_kernels_avx512 __attribute__((weak));
+
+/* The named table (NULL = the best one), if linked and supported by this
+ * CPU; otherwise nsaw_kernels_base */
+const nsaw_kernels_t *nsaw_kernels_select(const char *name);
+
+#endif /* NUSAW_KERNELS_H */
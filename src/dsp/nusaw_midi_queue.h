@@ -0,0 +1,92 @@
+/*
+ * nusaw_midi_queue.h - Sample-accurate MIDI event queue
+ *
+ * Each event carries a frame offset from the start of the next render
+ * call. The queue stays sorted by offset (arrival order among equal
+ * offsets); the render loop splits the engine render at the next pending
+ * offset and dispatches the events due there:
+ *
+ *   nsaw_midi_queue_next()       frame of the next pending event
+ *   nsaw_midi_queue_due()        pop one event due at or before a frame
+ *   nsaw_midi_queue_end_block()  after a render call: rebase what is
+ *                                left (events past its end carry over)
+ *
+ * Fixed capacity, no allocation: a full queue rejects the event. The
+ * caller can pop what is due up to the event's frame to make room (see
+ * queue_midi in nusaw_plugin.cpp).
+ */
+
+#ifndef NUSAW_MIDI_QUEUE_H
+#define NUSAW_MIDI_QUEUE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define NSAW_MIDI_QUEUE_SIZE 256
+
+typedef struct {
+    uint32_t frame;     /* Offset from the start of the next render call */
+    uint8_t msg[3];
+    uint8_t len;
+} nsaw_midi_event_t;
+
+typedef struct {
+    nsaw_midi_event_t events[NSAW_MIDI_QUEUE_SIZE];
+    int head;           /* First pending event */
+    int count;          /* One past the last pending event */
+} nsaw_midi_queue_t;
+
+static inline void nsaw_midi_queue_reset(nsaw_midi_queue_t *q) {
+    q->head = 0;
+    q->count = 0;
+}
+
+/* Insert in frame order after any events at the same frame; -1 if full */
+static inline int nsaw_midi_queue_push(nsaw_midi_queue_t *q, uint32_t frame,
+                                       const uint8_t *msg, int len) {
+    if (q->count == NSAW_MIDI_QUEUE_SIZE) {
+        if (q->head == 0) return -1;
+        memmove(q->events, q->events + q->head,
+                (q->count - q->head) * sizeof(nsaw_midi_event_t));
+        q->count -= q->head;
+        q->head = 0;
+    }
+
+    int i = q->count;
+    while (i > q->head && q->events[i - 1].frame > frame) {
+        q->events[i] = q->events[i - 1];
+        i--;
+    }
+    nsaw_midi_event_t *ev = &q->events[i];
+    ev->frame = frame;
+    ev->len = (uint8_t)(len < 3 ? len : 3);
+    memcpy(ev->msg, msg, ev->len);
+    q->count++;
+    return 0;
+}
+
+/* Frame of the next pending event (UINT32_MAX if none) */
+static inline uint32_t nsaw_midi_queue_next(const nsaw_midi_queue_t *q) {
+    return (q->head < q->count) ? q->events[q->head].frame : UINT32_MAX;
+}
+
+/* Pop the next event if it is due at or before `frame`, else NULL */
+static inline const nsaw_midi_event_t *nsaw_midi_queue_due(nsaw_midi_queue_t *q,
+                                                           uint32_t frame) {
+    if (q->head == q->count || q->events[q->head].frame > frame) return NULL;
+    return &q->events[q->head++];
+}
+
+/* A render call of `frames` is done: drop the dispatched events and make
+ * the remaining offsets relative to the next call */
+static inline void nsaw_midi_queue_end_block(nsaw_midi_queue_t *q, uint32_t frames) {
+    int n = 0;
+    for (int i = q->head; i < q->count; i++, n++) {
+        q->events[n] = q->events[i];
+        q->events[n].frame = (q->events[n].frame > frames) ? q->events[n].frame - frames : 0;
+    }
+    q->head = 0;
+    q->count = n;
+}
+
+#endif /* NUSAW_MIDI_QUEUE_H */
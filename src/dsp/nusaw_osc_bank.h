@@ -0,0 +1,516 @@
+/*
+ * nusaw_osc_bank.h - Vectorized unison saw oscillator bank
+ *
+ * Advances a bank of sawtooth oscillators by one sample and returns the
+ * stereo mix. State is laid out structure-of-arrays so the same oscillator
+ * slot of phase[], inc[], gain_l[] and gain_r[] lines up in one SIMD lane:
+ *
+ *   phase[j]   phase accumulator in [0, 1)      (read/write)
+ *   inc[j]     phase increment for this sample  (>= 0)
+ *   gain_l[j]  mix gain * left pan gain
+ *   gain_r[j]  mix gain * right pan gain
+ *
+ * One kernel per anti-aliasing tier (see nsaw_osc_quality_t):
+ *
+ *   nsaw_osc_bank_tick_naive    trivial saw, no correction
+ *   nsaw_osc_bank_tick_dpw      2nd-order differentiated parabolic wave
+ *   nsaw_osc_bank_tick          PolyBLEP (branchless, mask-based)
+ *   nsaw_osc_bank_tick_minblep  table-driven minimum-phase BLEP (scalar)
+ *
+ * plus nsaw_osc_bank_tick_wavetable, which reads mip-mapped band-limited
+ * saw tables instead of deriving the wave from the phase, and fixed-point
+ * phase variants of the naive and PolyBLEP kernels (*_q, see below).
+ *
+ * Kernels are written against the ob_* lane primitives below (NEON, SSE2,
+ * AVX or scalar, see nusaw_simd.h), with a scalar tail for the
+ * oscillators left over after the last full vector.
+ *
+ * nsaw_osc_bank_tick_scalar() is the PolyBLEP reference implementation and
+ * is kept for A/B comparison (see nsaw_engine_t.osc_kernel).
+ */
+
+#ifndef NUSAW_OSC_BANK_H
+#define NUSAW_OSC_BANK_H
+
+#include <stdint.h>
+#include "nusaw_osc_tables.h"
+#include "nusaw_simd.h"
+
+/* =====================================================================
+ * Lane primitives (ob_*): the nusaw_simd.h vectors at the native width
+ * (OB_LANES = NSAW_SIMD_WIDTH). vf = float lanes, vm = compare mask,
+ * vi = 32-bit integer lanes (wrapping add/sub, signed compare)
+ * ===================================================================== */
+
+#if NSAW_SIMD_WIDTH == 8
+#define OB_LANES 8
+typedef nsaw_f8 ob_vf;
+typedef nsaw_m8 ob_vm;
+typedef nsaw_i8 ob_vi;
+#define OB_F(op) nsaw_f8_##op
+#define OB_M(op) nsaw_m8_##op
+#define OB_I(op) nsaw_i8_##op
+#else
+#define OB_LANES 4
+typedef nsaw_f4 ob_vf;
+typedef nsaw_m4 ob_vm;
+typedef nsaw_i4 ob_vi;
+#define OB_F(op) nsaw_f4_##op
+#define OB_M(op) nsaw_m4_##op
+#define OB_I(op) nsaw_i4_##op
+#endif
+
+static inline ob_vf ob_load(const float *p)        { return OB_F(load)(p); }
+static inline void  ob_store(float *p, ob_vf v)    { OB_F(store)(p, v); }
+static inline ob_vf ob_set1(float x)               { return OB_F(set1)(x); }
+static inline ob_vf ob_add(ob_vf a, ob_vf b)       { return OB_F(add)(a, b); }
+static inline ob_vf ob_sub(ob_vf a, ob_vf b)       { return OB_F(sub)(a, b); }
+static inline ob_vf ob_mul(ob_vf a, ob_vf b)       { return OB_F(mul)(a, b); }
+static inline ob_vf ob_div(ob_vf a, ob_vf b)       { return OB_F(div)(a, b); }
+static inline ob_vf ob_max(ob_vf a, ob_vf b)       { return OB_F(max)(a, b); }
+static inline ob_vf ob_min(ob_vf a, ob_vf b)       { return OB_F(min)(a, b); }
+static inline ob_vm ob_eq(ob_vf a, ob_vf b)        { return OB_F(eq)(a, b); }
+static inline ob_vm ob_ge(ob_vf a, ob_vf b)        { return OB_F(ge)(a, b); }
+static inline ob_vm ob_gt(ob_vf a, ob_vf b)        { return OB_F(gt)(a, b); }
+static inline ob_vm ob_lt(ob_vf a, ob_vf b)        { return OB_F(lt)(a, b); }
+static inline ob_vm ob_and(ob_vm a, ob_vm b)       { return OB_M(and)(a, b); }
+static inline ob_vm ob_andnot(ob_vm a, ob_vm b)    { return OB_M(andnot)(a, b); }  /* b & ~a */
+static inline ob_vf ob_masked(ob_vm m, ob_vf v)    { return OB_F(masked)(m, v); }
+static inline ob_vf ob_select(ob_vm m, ob_vf a, ob_vf b) { return OB_F(select)(m, a, b); }  /* m ? a : b */
+static inline float ob_hsum(ob_vf v)               { return OB_F(hsum)(v); }
+
+static inline ob_vi ob_loadi(const uint32_t *p)    { return OB_I(load)(p); }
+static inline void  ob_storei(uint32_t *p, ob_vi v) { OB_I(store)(p, v); }
+static inline ob_vi ob_set1i(uint32_t x)           { return OB_I(set1)(x); }
+static inline ob_vi ob_addi(ob_vi a, ob_vi b)      { return OB_I(add)(a, b); }
+static inline ob_vi ob_subi(ob_vi a, ob_vi b)      { return OB_I(sub)(a, b); }
+static inline ob_vm ob_lti(ob_vi a, ob_vi b)       { return OB_I(lt)(a, b); }
+#if OB_LANES == 8
+static inline ob_vf ob_i2f(ob_vi a)                { return nsaw_i8_to_f8(a); }
+#else
+static inline ob_vf ob_i2f(ob_vi a)                { return nsaw_i4_to_f4(a); }
+#endif
+
+#undef OB_F
+#undef OB_M
+#undef OB_I
+
+/* Advance and wrap one vector of phases: subtract 1.0 where p >= 1 */
+static inline ob_vf ob_advance(float *phase, ob_vf dt) {
+    const ob_vf one = ob_set1(1.0f);
+    ob_vf p = ob_add(ob_load(phase), dt);
+    p = ob_sub(p, ob_masked(ob_ge(p, one), one));
+    ob_store(phase, p);
+    return p;
+}
+
+/* =====================================================================
+ * PolyBLEP
+ * ===================================================================== */
+
+/* PolyBLEP residual for anti-aliased sawtooth */
+static inline float nsaw_polyblep(float t, float dt) {
+    if (t < dt) {
+        t /= dt;
+        return t + t - t * t - 1.0f;
+    } else if (t > 1.0f - dt) {
+        t = (t - 1.0f) / dt;
+        return t * t + t + t + 1.0f;
+    }
+    return 0.0f;
+}
+
+/* Scalar reference kernel: oscillators [start, count) */
+static inline void nsaw_osc_bank_tick_range(float *phase, const float *inc,
+                                            const float *gain_l, const float *gain_r,
+                                            int start, int count,
+                                            float *out_l, float *out_r) {
+    float l = 0.0f;
+    float r = 0.0f;
+    for (int j = start; j < count; j++) {
+        float p = phase[j] + inc[j];
+        if (p >= 1.0f) p -= 1.0f;
+        phase[j] = p;
+
+        /* Naive sawtooth [-1,+1) minus PolyBLEP residual */
+        float saw = 2.0f * p - 1.0f - nsaw_polyblep(p, inc[j]);
+        l += saw * gain_l[j];
+        r += saw * gain_r[j];
+    }
+    *out_l += l;
+    *out_r += r;
+}
+
+static inline void nsaw_osc_bank_tick_scalar(float *phase, const float *inc,
+                                             const float *gain_l, const float *gain_r,
+                                             int count, float *out_l, float *out_r) {
+    *out_l = 0.0f;
+    *out_r = 0.0f;
+    nsaw_osc_bank_tick_range(phase, inc, gain_l, gain_r, 0, count, out_l, out_r);
+}
+
+/* SIMD kernel: full vectors across oscillators, scalar tail for the rest */
+static inline void nsaw_osc_bank_tick(float *phase, const float *inc,
+                                      const float *gain_l, const float *gain_r,
+                                      int count, float *out_l, float *out_r) {
+    int j = 0;
+    const ob_vf one = ob_set1(1.0f);
+    const ob_vf two = ob_set1(2.0f);
+    const ob_vf zero = ob_set1(0.0f);
+    ob_vf acc_l = zero;
+    ob_vf acc_r = zero;
+
+    for (; j + OB_LANES <= count; j += OB_LANES) {
+        ob_vf dt = ob_load(inc + j);
+        ob_vf p = ob_advance(phase + j, dt);
+
+        /* Branchless PolyBLEP: -(1-t)^2 just after the edge, (t+1)^2 just before */
+        ob_vf rdt = ob_div(one, dt);
+        ob_vf u = ob_sub(one, ob_mul(p, rdt));
+        ob_vf r1 = ob_sub(zero, ob_mul(u, u));
+        ob_vf w = ob_add(ob_mul(ob_sub(p, one), rdt), one);
+        ob_vf r2 = ob_mul(w, w);
+        ob_vm m1 = ob_lt(p, dt);
+        ob_vm m2 = ob_andnot(m1, ob_gt(p, ob_sub(one, dt)));
+        ob_vf res = ob_add(ob_masked(m1, r1), ob_masked(m2, r2));
+
+        ob_vf saw = ob_sub(ob_sub(ob_mul(two, p), one), res);
+        acc_l = ob_add(acc_l, ob_mul(saw, ob_load(gain_l + j)));
+        acc_r = ob_add(acc_r, ob_mul(saw, ob_load(gain_r + j)));
+    }
+    *out_l = ob_hsum(acc_l);
+    *out_r = ob_hsum(acc_r);
+
+    /* Scalar tail */
+    nsaw_osc_bank_tick_range(phase, inc, gain_l, gain_r, j, count, out_l, out_r);
+}
+
+/* =====================================================================
+ * Naive saw (eco / low notes)
+ * ===================================================================== */
+
+static inline void nsaw_osc_bank_tick_naive(float *phase, const float *inc,
+                                            const float *gain_l, const float *gain_r,
+                                            int count, float *out_l, float *out_r) {
+    int j = 0;
+    float l = 0.0f;
+    float r = 0.0f;
+
+    const ob_vf one = ob_set1(1.0f);
+    const ob_vf two = ob_set1(2.0f);
+    ob_vf acc_l = ob_set1(0.0f);
+    ob_vf acc_r = ob_set1(0.0f);
+
+    for (; j + OB_LANES <= count; j += OB_LANES) {
+        ob_vf p = ob_advance(phase + j, ob_load(inc + j));
+        ob_vf saw = ob_sub(ob_mul(two, p), one);
+        acc_l = ob_add(acc_l, ob_mul(saw, ob_load(gain_l + j)));
+        acc_r = ob_add(acc_r, ob_mul(saw, ob_load(gain_r + j)));
+    }
+    l = ob_hsum(acc_l);
+    r = ob_hsum(acc_r);
+
+    for (; j < count; j++) {
+        float p = phase[j] + inc[j];
+        if (p >= 1.0f) p -= 1.0f;
+        phase[j] = p;
+        float saw = 2.0f * p - 1.0f;
+        l += saw * gain_l[j];
+        r += saw * gain_r[j];
+    }
+    *out_l = l;
+    *out_r = r;
+}
+
+/* =====================================================================
+ * DPW (2nd order): differentiate the parabola s^2, s = 2p - 1
+ *   y = (s[n]^2 - s[n-1]^2) / (4 * inc)
+ * dpw_z[j] holds s[n-1]^2. Reset it to (2p - 1)^2 when entering the tier.
+ * ===================================================================== */
+
+/* Floor on the increment so the 1/(4*inc) scale stays finite */
+#define NSAW_DPW_MIN_INC 1.0e-6f
+
+static inline void nsaw_osc_bank_tick_dpw(float *phase, float *dpw_z, const float *inc,
+                                          const float *gain_l, const float *gain_r,
+                                          int count, float *out_l, float *out_r) {
+    int j = 0;
+    float l = 0.0f;
+    float r = 0.0f;
+
+    const ob_vf one = ob_set1(1.0f);
+    const ob_vf two = ob_set1(2.0f);
+    const ob_vf quarter = ob_set1(0.25f);
+    const ob_vf min_inc = ob_set1(NSAW_DPW_MIN_INC);
+    ob_vf acc_l = ob_set1(0.0f);
+    ob_vf acc_r = ob_set1(0.0f);
+
+    for (; j + OB_LANES <= count; j += OB_LANES) {
+        ob_vf dt = ob_load(inc + j);
+        ob_vf p = ob_advance(phase + j, dt);
+        ob_vf s = ob_sub(ob_mul(two, p), one);
+        ob_vf sq = ob_mul(s, s);
+        ob_vf saw = ob_div(ob_mul(ob_sub(sq, ob_load(dpw_z + j)), quarter),
+                           ob_max(dt, min_inc));
+        ob_store(dpw_z + j, sq);
+        acc_l = ob_add(acc_l, ob_mul(saw, ob_load(gain_l + j)));
+        acc_r = ob_add(acc_r, ob_mul(saw, ob_load(gain_r + j)));
+    }
+    l = ob_hsum(acc_l);
+    r = ob_hsum(acc_r);
+
+    for (; j < count; j++) {
+        float p = phase[j] + inc[j];
+        if (p >= 1.0f) p -= 1.0f;
+        phase[j] = p;
+        float s = 2.0f * p - 1.0f;
+        float sq = s * s;
+        float dt = inc[j] > NSAW_DPW_MIN_INC ? inc[j] : NSAW_DPW_MIN_INC;
+        float saw = (sq - dpw_z[j]) * 0.25f / dt;
+        dpw_z[j] = sq;
+        l += saw * gain_l[j];
+        r += saw * gain_r[j];
+    }
+    *out_l = l;
+    *out_r = r;
+}
+
+/* =====================================================================
+ * MinBLEP (table-driven, scalar)
+ *
+ * Each wrap is a -2 step at a fractional time t = p / inc after the edge.
+ * Its band-limiting correction -2 * gain * R(k + t), k = 0..TAPS-1, is
+ * summed into a per-voice stereo ring that is drained one sample per tick.
+ * Only oscillators that wrap on this sample pay for the correction.
+ * ===================================================================== */
+
+static inline void nsaw_osc_bank_tick_minblep(float *phase, const float *inc,
+                                              const float *gain_l, const float *gain_r,
+                                              int count, nsaw_minblep_state_t *st,
+                                              float *out_l, float *out_r) {
+    const float *table = nsaw_minblep_table();
+    const int mask = NSAW_MINBLEP_TAPS - 1;
+    float l = 0.0f;
+    float r = 0.0f;
+
+    for (int j = 0; j < count; j++) {
+        float p = phase[j] + inc[j];
+        if (p >= 1.0f) {
+            p -= 1.0f;
+            if (inc[j] > 0.0f) {
+                /* Fractional time since the edge, in table steps */
+                float t = p / inc[j];
+                if (t > 0.999f) t = 0.999f;
+                float x = t * (float)NSAW_MINBLEP_OVERSAMPLE;
+                int idx = (int)x;
+                float frac = x - (float)idx;
+                float hl = -2.0f * gain_l[j];
+                float hr = -2.0f * gain_r[j];
+                for (int k = 0; k < NSAW_MINBLEP_TAPS; k++) {
+                    const float *e = table + idx + k * NSAW_MINBLEP_OVERSAMPLE;
+                    float res = e[0] + frac * (e[1] - e[0]);
+                    int w = (st->pos + k) & mask;
+                    st->ring_l[w] += hl * res;
+                    st->ring_r[w] += hr * res;
+                }
+            }
+        }
+        phase[j] = p;
+        float saw = 2.0f * p - 1.0f;
+        l += saw * gain_l[j];
+        r += saw * gain_r[j];
+    }
+
+    /* Drain the current correction sample */
+    l += st->ring_l[st->pos];
+    r += st->ring_r[st->pos];
+    st->ring_l[st->pos] = 0.0f;
+    st->ring_r[st->pos] = 0.0f;
+    st->pos = (st->pos + 1) & mask;
+
+    *out_l = l;
+    *out_r = r;
+}
+
+/* =====================================================================
+ * Mip-mapped wavetable
+ *
+ * Level = ceil(log2(inc * NSAW_WT_SIZE)), taken straight from the float
+ * exponent (adding a full mantissa rounds up), then a linearly
+ * interpolated read at phase * NSAW_WT_SIZE. No edge handling at all:
+ * the tables are band-limited, so the wrap is just another sample.
+ * Table reads are per oscillator (there is no gather on NEON).
+ * ===================================================================== */
+
+static inline int nsaw_wavetable_level(float inc) {
+    union { float f; uint32_t u; } x;
+    x.f = inc * (float)NSAW_WT_SIZE;
+    int level = (int)((x.u + 0x007FFFFFu) >> 23) - 127;
+    if (level < 0) level = 0;
+    if (level > NSAW_WT_LEVELS - 1) level = NSAW_WT_LEVELS - 1;
+    return level;
+}
+
+static inline void nsaw_osc_bank_tick_wavetable(float *phase, const float *inc,
+                                                const float *gain_l, const float *gain_r,
+                                                int count, float *out_l, float *out_r) {
+    const float *tables = nsaw_saw_wavetable();
+    float l = 0.0f;
+    float r = 0.0f;
+
+    for (int j = 0; j < count; j++) {
+        float p = phase[j] + inc[j];
+        if (p >= 1.0f) p -= 1.0f;
+        phase[j] = p;
+
+        const float *t = tables + nsaw_wavetable_level(inc[j]) * NSAW_WT_STRIDE;
+        float x = p * (float)NSAW_WT_SIZE;
+        int i = (int)x;
+        float frac = x - (float)i;
+        float saw = t[i] + frac * (t[i + 1] - t[i]);
+        l += saw * gain_l[j];
+        r += saw * gain_r[j];
+    }
+    *out_l = l;
+    *out_r = r;
+}
+
+/* =====================================================================
+ * Fixed-point phase (naive and PolyBLEP)
+ *
+ * phase_q[j] is the phase as a 32-bit fraction of a cycle, offset by half
+ * a cycle: q = p * 2^32 + 2^31 (mod 2^32), and inc_q[j] = inc * 2^32.
+ * Read as a signed integer, q is the naive saw itself (2p - 1 = q * 2^-31),
+ * the wrap is integer overflow, and the frequency resolution is 2^-32 of
+ * the rate at any phase. The PolyBLEP windows are integer compares:
+ *   p < dt      <=>  q < inc_q - 2^31   (signed)
+ *   p > 1 - dt  <=>  2^31 - inc_q < q   (signed)
+ * Both hold only for inc_q < 2^31 (below Nyquist), so increments are
+ * clamped to NSAW_PHASE_Q_MAX_INC on conversion. Saws past it alias in
+ * any case; only their (already folded) pitch changes.
+ * ===================================================================== */
+
+#define NSAW_PHASE_Q_ONE 4294967296.0           /* 2^32 (double) */
+#define NSAW_PHASE_Q_HALF 0x80000000u
+#define NSAW_PHASE_Q_SAW (1.0f / 2147483648.0f) /* q -> 2p - 1 */
+#define NSAW_PHASE_Q_INC (1.0f / 4294967296.0f) /* inc_q -> inc */
+#define NSAW_PHASE_Q_MAX_INC 0.49f              /* cycles per tick */
+
+/* inc -> inc_q, clamped to [0, NSAW_PHASE_Q_MAX_INC] (a float past 2^32
+ * would not even convert) */
+static inline uint32_t nsaw_phase_q_inc(float inc) {
+    if (inc > NSAW_PHASE_Q_MAX_INC) inc = NSAW_PHASE_Q_MAX_INC;
+    if (inc < 0.0f) inc = 0.0f;
+    return (uint32_t)((double)inc * NSAW_PHASE_Q_ONE);
+}
+
+static inline void nsaw_osc_bank_tick_naive_q(uint32_t *phase, const uint32_t *inc,
+                                              const float *gain_l, const float *gain_r,
+                                              int count, float *out_l, float *out_r) {
+    int j = 0;
+    float l = 0.0f;
+    float r = 0.0f;
+
+    const ob_vf scale = ob_set1(NSAW_PHASE_Q_SAW);
+    ob_vf acc_l = ob_set1(0.0f);
+    ob_vf acc_r = ob_set1(0.0f);
+
+    for (; j + OB_LANES <= count; j += OB_LANES) {
+        ob_vi q = ob_addi(ob_loadi(phase + j), ob_loadi(inc + j));
+        ob_storei(phase + j, q);
+        ob_vf saw = ob_mul(ob_i2f(q), scale);
+        acc_l = ob_add(acc_l, ob_mul(saw, ob_load(gain_l + j)));
+        acc_r = ob_add(acc_r, ob_mul(saw, ob_load(gain_r + j)));
+    }
+    l = ob_hsum(acc_l);
+    r = ob_hsum(acc_r);
+
+    for (; j < count; j++) {
+        uint32_t q = phase[j] + inc[j];
+        phase[j] = q;
+        float saw = (float)(int32_t)q * NSAW_PHASE_Q_SAW;
+        l += saw * gain_l[j];
+        r += saw * gain_r[j];
+    }
+    *out_l = l;
+    *out_r = r;
+}
+
+/* Scalar PolyBLEP reference: oscillators [start, count) */
+static inline void nsaw_osc_bank_tick_range_q(uint32_t *phase, const uint32_t *inc,
+                                              const float *gain_l, const float *gain_r,
+                                              int start, int count,
+                                              float *out_l, float *out_r) {
+    float l = 0.0f;
+    float r = 0.0f;
+    for (int j = start; j < count; j++) {
+        uint32_t q = phase[j] + inc[j];
+        phase[j] = q;
+        float saw = (float)(int32_t)q * NSAW_PHASE_Q_SAW;
+
+        uint32_t u = q ^ NSAW_PHASE_Q_HALF;   /* plain phase, p * 2^32 */
+        if (u < inc[j]) {
+            float t = (float)u / (float)inc[j];
+            saw -= t + t - t * t - 1.0f;
+        } else if (u > 0u - inc[j]) {
+            float t = -(float)(0u - u) / (float)inc[j];
+            saw -= t * t + t + t + 1.0f;
+        }
+        l += saw * gain_l[j];
+        r += saw * gain_r[j];
+    }
+    *out_l += l;
+    *out_r += r;
+}
+
+static inline void nsaw_osc_bank_tick_scalar_q(uint32_t *phase, const uint32_t *inc,
+                                               const float *gain_l, const float *gain_r,
+                                               int count, float *out_l, float *out_r) {
+    *out_l = 0.0f;
+    *out_r = 0.0f;
+    nsaw_osc_bank_tick_range_q(phase, inc, gain_l, gain_r, 0, count, out_l, out_r);
+}
+
+static inline void nsaw_osc_bank_tick_q(uint32_t *phase, const uint32_t *inc,
+                                        const float *gain_l, const float *gain_r,
+                                        int count, float *out_l, float *out_r) {
+    int j = 0;
+    const ob_vf one = ob_set1(1.0f);
+    const ob_vf half = ob_set1(0.5f);
+    const ob_vf zero = ob_set1(0.0f);
+    const ob_vf saw_scale = ob_set1(NSAW_PHASE_Q_SAW);
+    const ob_vf inc_scale = ob_set1(NSAW_PHASE_Q_INC);
+    const ob_vi bias = ob_set1i(NSAW_PHASE_Q_HALF);
+    ob_vf acc_l = zero;
+    ob_vf acc_r = zero;
+
+    for (; j + OB_LANES <= count; j += OB_LANES) {
+        ob_vi dq = ob_loadi(inc + j);
+        ob_vi q = ob_addi(ob_loadi(phase + j), dq);
+        ob_storei(phase + j, q);
+
+        ob_vf naive = ob_mul(ob_i2f(q), saw_scale);
+        ob_vm m1 = ob_lti(q, ob_addi(dq, bias));
+        ob_vm m2 = ob_andnot(m1, ob_lti(ob_subi(bias, dq), q));
+
+        /* Residual as in the float kernel (inc_q < 2^31, so i2f is exact
+         * enough and non-negative) */
+        ob_vf p = ob_add(ob_mul(naive, half), half);
+        ob_vf rdt = ob_div(one, ob_mul(ob_i2f(dq), inc_scale));
+        ob_vf u = ob_sub(one, ob_mul(p, rdt));
+        ob_vf r1 = ob_sub(zero, ob_mul(u, u));
+        ob_vf w = ob_add(ob_mul(ob_sub(p, one), rdt), one);
+        ob_vf r2 = ob_mul(w, w);
+        ob_vf res = ob_add(ob_masked(m1, r1), ob_masked(m2, r2));
+
+        ob_vf saw = ob_sub(naive, res);
+        acc_l = ob_add(acc_l, ob_mul(saw, ob_load(gain_l + j)));
+        acc_r = ob_add(acc_r, ob_mul(saw, ob_load(gain_r + j)));
+    }
+    *out_l = ob_hsum(acc_l);
+    *out_r = ob_hsum(acc_r);
+
+    nsaw_osc_bank_tick_range_q(phase, inc, gain_l, gain_r, j, count, out_l, out_r);
+}
+
+#endif /* NUSAW_OSC_BANK_H */
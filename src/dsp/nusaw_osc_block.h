@@ -0,0 +1,187 @@
+/*
+ * nusaw_osc_block.h - Saw bank block kernels specialized per saw count
+ *
+ * The per-sample kernels in nusaw_osc_bank.h take the saw count at run
+ * time: every sample reloads phases, increments and gains from memory and
+ * finishes with a scalar tail. The kernels here render a whole control
+ * block for a saw count N fixed at compile time. The bank is loaded once
+ * into ceil(N / OB_LANES) vectors (lanes past N idle at phase 0 with zero
+ * increment and gain), the sample loop runs fully unrolled across them,
+ * and the phases are stored back at the end.
+ *
+ * Ramps follow osc_tables_advance() in nusaw_kernels.cpp: increments and
+ * gains step once per output sample, before that sample's os internal
+ * ticks. Output is the raw stereo mix (before normalization), one value
+ * per internal tick at out[i * stride].
+ *
+ * Kernels exist for the naive and PolyBLEP tiers, float and fixed-point
+ * phase, and every odd count 1..NSAW_MAX_OSC_VOICES that fits in
+ * NSAW_OSC_BLOCK_MAX_VECS vectors. nsaw_osc_block_kernel() returns NULL
+ * otherwise, in which case the caller ticks per sample.
+ */
+
+#ifndef NUSAW_OSC_BLOCK_H
+#define NUSAW_OSC_BLOCK_H
+
+#include <stddef.h>
+#include "nusaw_osc_bank.h"
+#include "nusaw_engine.h"
+
+/* Four live vectors per bank vector (phase, increment, two gains): NEON
+ * has registers for the whole bank, SSE/AVX only for four bank vectors
+ * before the kernel spills and loses to the per-sample loop (AVX-512
+ * builds have 32 registers again) */
+#if defined(NSAW_SIMD_NEON) || defined(__AVX512F__)
+#define NSAW_OSC_BLOCK_MAX_VECS 8
+#else
+#define NSAW_OSC_BLOCK_MAX_VECS 4
+#endif
+
+typedef enum {
+    NSAW_OSC_BLOCK_NAIVE = 0,
+    NSAW_OSC_BLOCK_POLYBLEP,
+    NSAW_OSC_BLOCK_NAIVE_Q,     /* fixed-point phase */
+    NSAW_OSC_BLOCK_POLYBLEP_Q,
+    NSAW_OSC_BLOCK_KINDS
+} nsaw_osc_block_kind_t;
+
+/* Bank state and per-block ramps (tables padded to whole vectors) */
+typedef struct {
+    float *phase;               /* float kinds */
+    uint32_t *phase_q;          /* fixed-point kinds */
+    const float *inc, *inc_step;
+    const uint32_t *inc_q, *inc_q_step;
+    const float *gain_l, *gain_l_step;
+    const float *gain_r, *gain_r_step;
+} nsaw_osc_block_args_t;
+
+typedef void (*nsaw_osc_block_fn)(const nsaw_osc_block_args_t *a, int frames, int os,
+                                  float *out_l, float *out_r, int stride);
+
+template <int N, int KIND>
+static void nsaw_osc_block(const nsaw_osc_block_args_t *a, int frames, int os,
+                           float *out_l, float *out_r, int stride) {
+    enum { V = (N + OB_LANES - 1) / OB_LANES };
+    const bool fixed = (KIND == NSAW_OSC_BLOCK_NAIVE_Q || KIND == NSAW_OSC_BLOCK_POLYBLEP_Q);
+    const bool blep = (KIND == NSAW_OSC_BLOCK_POLYBLEP || KIND == NSAW_OSC_BLOCK_POLYBLEP_Q);
+
+    const ob_vf one = ob_set1(1.0f);
+    const ob_vf two = ob_set1(2.0f);
+    const ob_vf half = ob_set1(0.5f);
+    const ob_vf zero = ob_set1(0.0f);
+    const ob_vf saw_scale = ob_set1(NSAW_PHASE_Q_SAW);
+    const ob_vf inc_scale = ob_set1(NSAW_PHASE_Q_INC);
+    const ob_vi bias = ob_set1i(NSAW_PHASE_Q_HALF);
+
+    /* Phases are not padded in the voice; stage them through a local copy */
+    float pf[V * OB_LANES] NSAW_ALIGNED;
+    uint32_t pq[V * OB_LANES] NSAW_ALIGNED;
+    for (int j = 0; j < V * OB_LANES; j++) {
+        if (fixed) pq[j] = (j < N) ? a->phase_q[j] : NSAW_PHASE_Q_HALF;  /* p = 0 */
+        else pf[j] = (j < N) ? a->phase[j] : 0.0f;
+    }
+
+    /* Phases, increments and gains live in registers; the steps are read
+     * from the tables each sample (fewer live vectors for large N) */
+    ob_vf p[V], dt[V], gl[V], gr[V];
+    ob_vi q[V], dq[V];
+    for (int k = 0; k < V; k++) {
+        int j = k * OB_LANES;
+        if (fixed) {
+            q[k] = ob_loadi(pq + j);
+            dq[k] = ob_loadi(a->inc_q + j);
+        } else {
+            p[k] = ob_load(pf + j);
+            dt[k] = ob_load(a->inc + j);
+        }
+        gl[k] = ob_load(a->gain_l + j);
+        gr[k] = ob_load(a->gain_r + j);
+    }
+
+    int w = 0;
+    for (int n = 0; n < frames; n++) {
+        for (int k = 0; k < V; k++) {
+            int j = k * OB_LANES;
+            if (fixed) dq[k] = ob_addi(dq[k], ob_loadi(a->inc_q_step + j));
+            else dt[k] = ob_add(dt[k], ob_load(a->inc_step + j));
+            gl[k] = ob_add(gl[k], ob_load(a->gain_l_step + j));
+            gr[k] = ob_add(gr[k], ob_load(a->gain_r_step + j));
+        }
+
+        for (int s = 0; s < os; s++, w += stride) {
+            ob_vf acc_l = zero;
+            ob_vf acc_r = zero;
+
+            for (int k = 0; k < V; k++) {
+                ob_vf saw, ph, rdt;
+                ob_vm m1, m2;
+
+                if (fixed) {
+                    q[k] = ob_addi(q[k], dq[k]);
+                    saw = ob_mul(ob_i2f(q[k]), saw_scale);
+                    if (blep) {
+                        m1 = ob_lti(q[k], ob_addi(dq[k], bias));
+                        m2 = ob_andnot(m1, ob_lti(ob_subi(bias, dq[k]), q[k]));
+                        ph = ob_add(ob_mul(saw, half), half);
+                        rdt = ob_div(one, ob_mul(ob_i2f(dq[k]), inc_scale));
+                    }
+                } else {
+                    p[k] = ob_add(p[k], dt[k]);
+                    p[k] = ob_sub(p[k], ob_masked(ob_ge(p[k], one), one));
+                    saw = ob_sub(ob_mul(two, p[k]), one);
+                    if (blep) {
+                        m1 = ob_lt(p[k], dt[k]);
+                        m2 = ob_andnot(m1, ob_gt(p[k], ob_sub(one, dt[k])));
+                        ph = p[k];
+                        rdt = ob_div(one, dt[k]);
+                    }
+                }
+
+                if (blep) {
+                    /* Branchless PolyBLEP, as nsaw_osc_bank_tick() */
+                    ob_vf u = ob_sub(one, ob_mul(ph, rdt));
+                    ob_vf r1 = ob_sub(zero, ob_mul(u, u));
+                    ob_vf v = ob_add(ob_mul(ob_sub(ph, one), rdt), one);
+                    ob_vf r2 = ob_mul(v, v);
+                    saw = ob_sub(saw, ob_add(ob_masked(m1, r1), ob_masked(m2, r2)));
+                }
+
+                acc_l = ob_add(acc_l, ob_mul(saw, gl[k]));
+                acc_r = ob_add(acc_r, ob_mul(saw, gr[k]));
+            }
+
+            out_l[w] = ob_hsum(acc_l);
+            out_r[w] = ob_hsum(acc_r);
+        }
+    }
+
+    for (int k = 0; k < V; k++) {
+        if (fixed) ob_storei(pq + k * OB_LANES, q[k]);
+        else ob_store(pf + k * OB_LANES, p[k]);
+    }
+    for (int j = 0; j < N; j++) {
+        if (fixed) a->phase_q[j] = pq[j];
+        else a->phase[j] = pf[j];
+    }
+}
+
+#define NSAW_OSC_BLOCK_ROW(K) {                                             \
+    nsaw_osc_block<1, K>,  nsaw_osc_block<3, K>,  nsaw_osc_block<5, K>,     \
+    nsaw_osc_block<7, K>,  nsaw_osc_block<9, K>,  nsaw_osc_block<11, K>,    \
+    nsaw_osc_block<13, K>, nsaw_osc_block<15, K>, nsaw_osc_block<17, K>,    \
+    nsaw_osc_block<19, K>, nsaw_osc_block<21, K>, nsaw_osc_block<23, K>,    \
+    nsaw_osc_block<25, K> }
+
+static inline nsaw_osc_block_fn nsaw_osc_block_kernel(int kind, int count) {
+    static const nsaw_osc_block_fn kernels[NSAW_OSC_BLOCK_KINDS][NSAW_MAX_DETUNE_PAIRS + 1] = {
+        NSAW_OSC_BLOCK_ROW(NSAW_OSC_BLOCK_NAIVE),
+        NSAW_OSC_BLOCK_ROW(NSAW_OSC_BLOCK_POLYBLEP),
+        NSAW_OSC_BLOCK_ROW(NSAW_OSC_BLOCK_NAIVE_Q),
+        NSAW_OSC_BLOCK_ROW(NSAW_OSC_BLOCK_POLYBLEP_Q),
+    };
+    if (count < 1 || count > NSAW_MAX_OSC_VOICES || !(count & 1)) return NULL;
+    if (count > NSAW_OSC_BLOCK_MAX_VECS * OB_LANES) return NULL;
+    return kernels[kind][count >> 1];
+}
+
+#endif /* NUSAW_OSC_BLOCK_H */
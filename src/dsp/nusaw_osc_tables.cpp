@@ -0,0 +1,171 @@
+/*
+ * nusaw_osc_tables.cpp - Precomputed oscillator tables
+ *
+ * minBLEP construction (Brandt, "Hard Sync Without Aliasing"):
+ *   1. Blackman-windowed sinc spanning NSAW_MINBLEP_TAPS samples
+ *   2. Real cepstrum, folded to make it minimum phase
+ *   3. Back to the time domain, integrate to a step, normalize to 1
+ *   4. Residual = band-limited step - ideal step
+ *
+ * Saw wavetables: additive synthesis of 2p - 1 = -(2/pi) sum sin(2 pi k p)/k
+ * up to each level's harmonic limit, done as one inverse FFT per level.
+ */
+
+#include "nusaw_osc_tables.h"
+#include <math.h>
+#include <stdlib.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Cepstrum FFT size (zero-padded 4x to limit cepstral aliasing) */
+#define MINBLEP_POINTS (NSAW_MINBLEP_TAPS * NSAW_MINBLEP_OVERSAMPLE)
+#define MINBLEP_FFT_SIZE (MINBLEP_POINTS * 4)
+
+static float g_minblep[NSAW_MINBLEP_TABLE_SIZE];
+static float g_saw_wt[NSAW_WT_LEVELS * NSAW_WT_STRIDE];
+static int g_tables_ready = 0;
+
+/* In-place iterative radix-2 complex FFT (n = power of two) */
+static void fft(double *re, double *im, int n, int inverse) {
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+        double ang = 2.0 * M_PI / len * (inverse ? 1.0 : -1.0);
+        double wr = cos(ang), wi = sin(ang);
+        for (int i = 0; i < n; i += len) {
+            double cr = 1.0, ci = 0.0;
+            for (int k = 0; k < len / 2; k++) {
+                int a = i + k, b = i + k + len / 2;
+                double xr = re[b] * cr - im[b] * ci;
+                double xi = re[b] * ci + im[b] * cr;
+                re[b] = re[a] - xr; im[b] = im[a] - xi;
+                re[a] += xr;        im[a] += xi;
+                double t = cr * wr - ci * wi;
+                ci = cr * wi + ci * wr;
+                cr = t;
+            }
+        }
+    }
+    if (inverse) {
+        for (int i = 0; i < n; i++) { re[i] /= n; im[i] /= n; }
+    }
+}
+
+static void build_minblep(void) {
+    const int n = MINBLEP_FFT_SIZE;
+    double *re = (double*)calloc(n, sizeof(double));
+    double *im = (double*)calloc(n, sizeof(double));
+    if (!re || !im) {
+        free(re);
+        free(im);
+        return;
+    }
+
+    /* 1. Windowed sinc, centered, zero crossings every OVERSAMPLE points */
+    for (int i = 0; i < MINBLEP_POINTS; i++) {
+        double x = (double)(i - MINBLEP_POINTS / 2) / NSAW_MINBLEP_OVERSAMPLE;
+        double sinc = (x == 0.0) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+        double w = (double)i / (MINBLEP_POINTS - 1);
+        double blackman = 0.42 - 0.5 * cos(2.0 * M_PI * w) + 0.08 * cos(4.0 * M_PI * w);
+        re[i] = sinc * blackman;
+    }
+
+    /* 2. Real cepstrum: IFFT(log|FFT(x)|) */
+    fft(re, im, n, 0);
+    for (int i = 0; i < n; i++) {
+        double mag = sqrt(re[i] * re[i] + im[i] * im[i]);
+        re[i] = log(mag > 1e-20 ? mag : 1e-20);
+        im[i] = 0.0;
+    }
+    fft(re, im, n, 1);
+
+    /* Fold the cepstrum onto positive quefrencies (minimum phase) */
+    for (int i = 1; i < n / 2; i++) re[i] *= 2.0;
+    for (int i = n / 2 + 1; i < n; i++) re[i] = 0.0;
+    for (int i = 0; i < n; i++) im[i] = 0.0;
+
+    /* 3. exp(FFT(cepstrum)) and back to the time domain */
+    fft(re, im, n, 0);
+    for (int i = 0; i < n; i++) {
+        double m = exp(re[i]);
+        double ph = im[i];
+        re[i] = m * cos(ph);
+        im[i] = m * sin(ph);
+    }
+    fft(re, im, n, 1);
+
+    /* Integrate the minimum-phase impulse into a step */
+    double sum = 0.0;
+    for (int i = 0; i < MINBLEP_POINTS; i++) {
+        sum += re[i];
+        re[i] = sum;
+    }
+
+    /* 4. Normalize to a unit step and keep the residual */
+    for (int i = 0; i < MINBLEP_POINTS; i++) {
+        g_minblep[i] = (float)(re[i] / sum - 1.0);
+    }
+    g_minblep[MINBLEP_POINTS] = 0.0f;  /* guard point for interpolation */
+
+    free(re);
+    free(im);
+}
+
+static void build_saw_wavetables(void) {
+    const int n = NSAW_WT_SIZE;
+    double *re = (double*)malloc(n * sizeof(double));
+    double *im = (double*)malloc(n * sizeof(double));
+    if (!re || !im) {
+        free(re);
+        free(im);
+        return;
+    }
+
+    for (int level = 0; level < NSAW_WT_LEVELS; level++) {
+        /* Highest increment served by this level */
+        double inc_top = (double)(1 << level) / n;
+        int harmonics = (int)(NSAW_WT_BAND_LIMIT / inc_top);
+        if (harmonics > n / 2 - 1) harmonics = n / 2 - 1;
+        if (harmonics < 1) harmonics = 1;
+
+        /* sin(2 pi k i / n) * a_k  <->  X[k] = -i n a_k / 2, X[n-k] = conj */
+        for (int i = 0; i < n; i++) { re[i] = 0.0; im[i] = 0.0; }
+        for (int k = 1; k <= harmonics; k++) {
+            double a = -2.0 / (M_PI * k);
+            im[k]     = -0.5 * n * a;
+            im[n - k] =  0.5 * n * a;
+        }
+        fft(re, im, n, 1);
+
+        float *t = g_saw_wt + level * NSAW_WT_STRIDE;
+        for (int i = 0; i < n; i++) t[i] = (float)re[i];
+        t[n] = t[0];  /* guard point for interpolation */
+    }
+
+    free(re);
+    free(im);
+}
+
+void nsaw_osc_tables_init(void) {
+    if (g_tables_ready) return;
+    build_minblep();
+    build_saw_wavetables();
+    g_tables_ready = 1;
+}
+
+const float *nsaw_minblep_table(void) {
+    return g_minblep;
+}
+
+const float *nsaw_saw_wavetable(void) {
+    return g_saw_wt;
+}
@@ -0,0 +1,55 @@
+/*
+ * nusaw_osc_tables.h - Precomputed oscillator tables
+ *
+ * Tables are built once per process by nsaw_osc_tables_init() (called from
+ * nsaw_engine_init, never from the audio thread) and are read-only after.
+ *
+ *   minBLEP residual   minimum-phase band-limited step minus the ideal
+ *                      step, NSAW_MINBLEP_TAPS samples long, oversampled
+ *                      NSAW_MINBLEP_OVERSAMPLE times (+1 guard point)
+ *   saw wavetables     one band-limited saw per octave of increment,
+ *                      NSAW_WT_SIZE samples each (+1 guard point)
+ */
+
+#ifndef NUSAW_OSC_TABLES_H
+#define NUSAW_OSC_TABLES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* minBLEP residual: 16 output samples, 64x oversampled */
+#define NSAW_MINBLEP_TAPS 16         /* power of two (ring buffer size) */
+#define NSAW_MINBLEP_OVERSAMPLE 64
+#define NSAW_MINBLEP_TABLE_SIZE (NSAW_MINBLEP_TAPS * NSAW_MINBLEP_OVERSAMPLE + 1)
+
+/* Per-voice pending minBLEP corrections (stereo ring) */
+typedef struct {
+    float ring_l[NSAW_MINBLEP_TAPS];
+    float ring_r[NSAW_MINBLEP_TAPS];
+    int pos;
+} nsaw_minblep_state_t;
+
+/* Mip-mapped saw wavetables.
+ * Level n serves increments up to 2^n / NSAW_WT_SIZE (level 10 = Nyquist).
+ * Harmonics are cut at NSAW_WT_BAND_LIMIT * sample rate at the top of each
+ * level, so aliases only fold back above (1 - limit) * sr (18 kHz at 44.1k). */
+#define NSAW_WT_SIZE 2048            /* power of two */
+#define NSAW_WT_LEVELS 11            /* log2(NSAW_WT_SIZE) for the top level */
+#define NSAW_WT_STRIDE (NSAW_WT_SIZE + 1)
+#define NSAW_WT_BAND_LIMIT 0.59f
+
+/* Build all tables (idempotent; not real-time safe) */
+void nsaw_osc_tables_init(void);
+
+/* minBLEP residual table, NSAW_MINBLEP_TABLE_SIZE entries */
+const float *nsaw_minblep_table(void);
+
+/* Saw wavetables, NSAW_WT_LEVELS levels of NSAW_WT_STRIDE entries */
+const float *nsaw_saw_wavetable(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NUSAW_OSC_TABLES_H */
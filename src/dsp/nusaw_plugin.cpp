@@ -50,16 +50,44 @@ typedef struct plugin_api_v2 {
 typedef plugin_api_v2_t* (*move_plugin_init_v2_fn)(const host_api_v1_t *host);
 #define MOVE_PLUGIN_INIT_V2_SYMBOL "move_plugin_init_v2"
 
+/* NuSaw extension for offline tools (look up with dlsym): render_block
+ * for any frame count with soft-clipped float output instead of int16,
+ * always at full quality (the CPU governor is bypassed) */
+typedef void (*nsaw_render_float_fn)(void *instance, float *out_left, float *out_right,
+                                     int frames);
+#define NSAW_RENDER_FLOAT_SYMBOL "nsaw_render_float"
+
+/* NuSaw extensions for timestamped MIDI (look up with dlsym). frame is
+ * the offset from the start of the next render call; on_midi events land
+ * at frame 0. The bulk form takes packed records, each a 16-bit little-
+ * endian frame offset followed by one complete channel message (no
+ * running status), and returns the number of events queued. */
+typedef void (*nsaw_on_midi_timed_fn)(void *instance, const uint8_t *msg, int len,
+                                      int source, int frame);
+typedef int (*nsaw_on_midi_bulk_fn)(void *instance, const uint8_t *buf, int len, int source);
+#define NSAW_ON_MIDI_TIMED_SYMBOL "nsaw_on_midi_timed"
+#define NSAW_ON_MIDI_BULK_SYMBOL "nsaw_on_midi_bulk"
+
 /* Engine */
 #include "nusaw_engine.h"
 }
 
 /* Include param helper */
 #include "param_helper.h"
+#include "nusaw_governor.h"
+#include "nusaw_kernels.h"
+#include "nusaw_denormal.h"
+#include "nusaw_halfband.h"
+#include "nusaw_midi_queue.h"
+#include "nusaw_triple_buffer.h"
+#include "nusaw_fastmath.h"
 
 /* Host API reference */
 static const host_api_v1_t *g_host = NULL;
 
+/* Render kernels for this CPU, picked once at move_plugin_init_v2 */
+static const nsaw_kernels_t *g_kernels = &nsaw_kernels_base;
+
 static void plugin_log(const char *msg) {
     if (g_host && g_host->log) {
         char buf[256];
@@ -98,35 +126,47 @@ enum {
     P_DELAY_FBACK,
     P_DELAY_MIX,
     P_DELAY_TONE,
+    P_OSC_QUALITY,
+    P_OSC_MODE,
+    P_OVERSAMPLE,
+    P_POLYPHONY,
+    P_RENDER_RATE,
     P_COUNT
 };
 
+/* Continuous params declare a smoothing time (ms); the render loop applies
+ * it once per control block (see param_helper_smooth_step) */
 static const param_def_t g_shadow_params[] = {
-    {"cutoff",      "Cutoff",       PARAM_TYPE_FLOAT, P_CUTOFF,     0.0f, 1.0f},
-    {"resonance",   "Resonance",    PARAM_TYPE_FLOAT, P_RESONANCE,  0.0f, 1.0f},
-    {"detune",      "Detune",       PARAM_TYPE_FLOAT, P_DETUNE,     0.0f, 1.0f},
-    {"spread",      "Spread",       PARAM_TYPE_FLOAT, P_SPREAD,     0.0f, 1.0f},
-    {"f_amount",    "Filt Env Amt", PARAM_TYPE_FLOAT, P_F_AMOUNT,   0.0f, 1.0f},
-    {"attack",      "Attack",       PARAM_TYPE_FLOAT, P_ATTACK,     0.0f, 1.0f},
-    {"decay",       "Decay",        PARAM_TYPE_FLOAT, P_DECAY,      0.0f, 1.0f},
-    {"sustain",     "Sustain",      PARAM_TYPE_FLOAT, P_SUSTAIN,    0.0f, 1.0f},
-    {"release",     "Release",      PARAM_TYPE_FLOAT, P_RELEASE,    0.0f, 1.0f},
-    {"f_attack",    "F Attack",     PARAM_TYPE_FLOAT, P_F_ATTACK,   0.0f, 1.0f},
-    {"f_decay",     "F Decay",      PARAM_TYPE_FLOAT, P_F_DECAY,    0.0f, 1.0f},
-    {"f_sustain",   "F Sustain",    PARAM_TYPE_FLOAT, P_F_SUSTAIN,  0.0f, 1.0f},
-    {"f_release",   "F Release",    PARAM_TYPE_FLOAT, P_F_RELEASE,  0.0f, 1.0f},
-    {"volume",      "Volume",       PARAM_TYPE_FLOAT, P_VOLUME,     0.0f, 1.0f},
-    {"vel_sens",    "Vel Sens",     PARAM_TYPE_FLOAT, P_VEL_SENS,   0.0f, 1.0f},
-    {"bend_range",  "Bend Range",   PARAM_TYPE_FLOAT, P_BEND_RANGE, 0.0f, 1.0f},
-    {"sub_level",   "Sub",          PARAM_TYPE_FLOAT, P_SUB_LEVEL,  0.0f, 1.0f},
-    {"sub_octave",  "Sub Oct",      PARAM_TYPE_INT,   P_SUB_OCTAVE, -2.0f, 0.0f},
-    {"saw_count",   "Saws",         PARAM_TYPE_INT,   P_SAW_COUNT,   3.0f, 25.0f},
-    {"chorus_mix",  "Chorus",       PARAM_TYPE_FLOAT, P_CHORUS_MIX,  0.0f, 1.0f},
-    {"chorus_depth","Chr Depth",    PARAM_TYPE_FLOAT, P_CHORUS_DEPTH,0.0f, 1.0f},
-    {"delay_time",  "Dly Time",     PARAM_TYPE_FLOAT, P_DELAY_TIME,  0.0f, 1.0f},
-    {"delay_fback", "Dly Fback",    PARAM_TYPE_FLOAT, P_DELAY_FBACK, 0.0f, 1.0f},
-    {"delay_mix",   "Delay",        PARAM_TYPE_FLOAT, P_DELAY_MIX,   0.0f, 1.0f},
-    {"delay_tone",  "Dly Tone",     PARAM_TYPE_FLOAT, P_DELAY_TONE,  0.0f, 1.0f},
+    {"cutoff",      "Cutoff",       PARAM_TYPE_FLOAT, P_CUTOFF,     0.0f, 1.0f,  5.0f},
+    {"resonance",   "Resonance",    PARAM_TYPE_FLOAT, P_RESONANCE,  0.0f, 1.0f,  5.0f},
+    {"detune",      "Detune",       PARAM_TYPE_FLOAT, P_DETUNE,     0.0f, 1.0f,  5.0f},
+    {"spread",      "Spread",       PARAM_TYPE_FLOAT, P_SPREAD,     0.0f, 1.0f,  5.0f},
+    {"f_amount",    "Filt Env Amt", PARAM_TYPE_FLOAT, P_F_AMOUNT,   0.0f, 1.0f,  5.0f},
+    {"attack",      "Attack",       PARAM_TYPE_FLOAT, P_ATTACK,     0.0f, 1.0f,  0.0f},
+    {"decay",       "Decay",        PARAM_TYPE_FLOAT, P_DECAY,      0.0f, 1.0f,  0.0f},
+    {"sustain",     "Sustain",      PARAM_TYPE_FLOAT, P_SUSTAIN,    0.0f, 1.0f,  0.0f},
+    {"release",     "Release",      PARAM_TYPE_FLOAT, P_RELEASE,    0.0f, 1.0f,  0.0f},
+    {"f_attack",    "F Attack",     PARAM_TYPE_FLOAT, P_F_ATTACK,   0.0f, 1.0f,  0.0f},
+    {"f_decay",     "F Decay",      PARAM_TYPE_FLOAT, P_F_DECAY,    0.0f, 1.0f,  0.0f},
+    {"f_sustain",   "F Sustain",    PARAM_TYPE_FLOAT, P_F_SUSTAIN,  0.0f, 1.0f,  0.0f},
+    {"f_release",   "F Release",    PARAM_TYPE_FLOAT, P_F_RELEASE,  0.0f, 1.0f,  0.0f},
+    {"volume",      "Volume",       PARAM_TYPE_FLOAT, P_VOLUME,     0.0f, 1.0f,  5.0f},
+    {"vel_sens",    "Vel Sens",     PARAM_TYPE_FLOAT, P_VEL_SENS,   0.0f, 1.0f,  0.0f},
+    {"bend_range",  "Bend Range",   PARAM_TYPE_FLOAT, P_BEND_RANGE, 0.0f, 1.0f,  0.0f},
+    {"sub_level",   "Sub",          PARAM_TYPE_FLOAT, P_SUB_LEVEL,  0.0f, 1.0f,  5.0f},
+    {"sub_octave",  "Sub Oct",      PARAM_TYPE_INT,   P_SUB_OCTAVE, -2.0f, 0.0f,  0.0f},
+    {"saw_count",   "Saws",         PARAM_TYPE_INT,   P_SAW_COUNT,   3.0f, 25.0f,  0.0f},
+    {"chorus_mix",  "Chorus",       PARAM_TYPE_FLOAT, P_CHORUS_MIX,  0.0f, 1.0f, 10.0f},
+    {"chorus_depth","Chr Depth",    PARAM_TYPE_FLOAT, P_CHORUS_DEPTH,0.0f, 1.0f, 10.0f},
+    {"delay_time",  "Dly Time",     PARAM_TYPE_FLOAT, P_DELAY_TIME,  0.0f, 1.0f,  0.0f},
+    {"delay_fback", "Dly Fback",    PARAM_TYPE_FLOAT, P_DELAY_FBACK, 0.0f, 1.0f, 10.0f},
+    {"delay_mix",   "Delay",        PARAM_TYPE_FLOAT, P_DELAY_MIX,   0.0f, 1.0f, 10.0f},
+    {"delay_tone",  "Dly Tone",     PARAM_TYPE_FLOAT, P_DELAY_TONE,  0.0f, 1.0f, 10.0f},
+    {"osc_quality", "Quality",      PARAM_TYPE_INT,   P_OSC_QUALITY, 0.0f, 4.0f,  0.0f},
+    {"osc_mode",    "Osc Mode",     PARAM_TYPE_INT,   P_OSC_MODE,    0.0f, 1.0f,  0.0f},
+    {"oversample",  "Oversample",   PARAM_TYPE_INT,   P_OVERSAMPLE,  0.0f, 2.0f,  0.0f},
+    {"polyphony",   "Voices",       PARAM_TYPE_INT,   P_POLYPHONY,   0.0f, 32.0f, 0.0f},
+    {"render_rate", "Render Rate",  PARAM_TYPE_INT,   P_RENDER_RATE, 0.0f, 1.0f,  0.0f},
 };
 
 /* =====================================================================
@@ -147,6 +187,9 @@ struct NsawPreset {
  *                  f_attack, f_decay, f_sustain, f_release,
  *                  volume, vel_sens, bend_range, sub_level, sub_octave, saw_count,
  *                  chorus_mix, chorus_depth, delay_time, delay_fback, delay_mix, delay_tone
+ * Trailing params left out of a preset default to 0 (osc_quality: auto,
+ * osc_mode: analytic, oversample: auto 2x, polyphony: 8 voices).
+ * render_rate is not taken from presets (see apply_preset).
  *
  * Envelope time reference (param_to_seconds = 0.001 * 10000^p):
  *   0.00=1ms  0.25=10ms  0.35=25ms  0.40=40ms  0.42=50ms  0.45=63ms
@@ -426,18 +469,26 @@ static const NsawPreset g_factory_presets[] = {
  * Effects state
  * ===================================================================== */
 
-#define CHORUS_BUF_SIZE 512
-#define DELAY_MAX_SAMPLES 44100  /* 1 second at 44.1kHz */
+/* Juno-60 chorus delay range */
+#define CHORUS_MIN_DELAY_MS 1.66f
+#define CHORUS_MAX_DELAY_MS 5.35f
 
+#define DELAY_MAX_SECONDS 1.0f
+
+/* Buffers are sized for the host rate at instance creation */
 typedef struct {
+    float sample_rate;
+
     /* Chorus */
-    float chorus_buf[CHORUS_BUF_SIZE];
+    float *chorus_buf;   /* heap: chorus_size floats (power of two) */
+    int chorus_size;
     int chorus_write_pos;
     float lfo1_phase, lfo2_phase;
 
     /* Delay */
-    float *delay_buf_l;  /* heap: DELAY_MAX_SAMPLES floats */
+    float *delay_buf_l;  /* heap: delay_size floats (DELAY_MAX_SECONDS) */
     float *delay_buf_r;
+    int delay_size;
     int delay_write_pos;
     float tone_z1_l, tone_z1_r;  /* one-pole filter state */
 } nsaw_effects_t;
@@ -446,6 +497,26 @@ typedef struct {
  * Instance
  * ===================================================================== */
 
+#define NSAW_MAX_RETIRED_POOLS 4
+
+/* Everything set_param can change, as one snapshot for the audio thread.
+ * One-shot requests are counters: the audio thread acts when they move. */
+typedef struct {
+    float params[P_COUNT];
+    int octave_transpose;
+    int control_block;
+    int osc_kernel;             /* nsaw_osc_kernel_t */
+    int phase_mode;             /* nsaw_phase_mode_t */
+    int fast_paths;
+    int unison_lod;
+    const nsaw_kernels_t *kernels;
+    float cpu_target;
+    nsaw_worker_pool_t *pool;   /* NULL = render on the audio thread only */
+    uint32_t pool_gen;          /* pool switches so far */
+    uint32_t notes_off;         /* all_notes_off requests so far */
+    uint32_t resync;            /* state restores (snap smoothing) so far */
+} nsaw_settings_t;
+
 typedef struct {
     char module_dir[256];
     nsaw_engine_t engine;
@@ -456,55 +527,193 @@ typedef struct {
     NsawPreset presets[MAX_PRESETS];
     int octave_transpose;
     nsaw_effects_t fx;
+
+    /* Control thread: ctl holds the settings (what get_param reports) and
+     * current_preset/preset_name go with it. set_param edits ctl and
+     * publishes a copy through ctl_tb; the audio thread takes the newest
+     * copy at the start of a render call, never a half-applied one.
+     * params/octave_transpose above and the engine are audio-thread state. */
+    nsaw_settings_t ctl;
+    nsaw_settings_t ctl_slots[3];
+    nsaw_triple_buffer_t ctl_tb;
+    uint32_t notes_off_seen, resync_seen;
+
+    /* Host rate; the engine renders at render_rate times it (1 or 2,
+     * P_RENDER_RATE) and 2x output is decimated back by down_l/down_r */
+    float sample_rate;
+    int render_rate;
+    nsaw_halfband_t down_l, down_r;
+
+    /* Control-rate smoothing: params[] are targets, smoothed[] are the
+     * effective values handed to the engine and effects each control block */
+    param_smoother_t smoothers[P_COUNT];
+    float smoothed[P_COUNT];
+
+    /* MIDI events waiting for their frame in the coming render calls */
+    nsaw_midi_queue_t midi;
+
+    /* Worker pools replaced through ctl.pool. The control thread frees
+     * them once the audio thread has switched to the latest one
+     * (pool_ack == ctl.pool_gen) and so cannot be inside them any more. */
+    nsaw_worker_pool_t *retired_pools[NSAW_MAX_RETIRED_POOLS];
+    int num_retired_pools;
+    uint32_t pool_ack;          /* atomic: pool_gen the engine renders with */
+
+    /* CPU-budget governor: render time vs. block deadline -> engine->degrade */
+    nsaw_governor_t gov;
 } nsaw_instance_t;
 
 static void apply_params_to_engine(nsaw_instance_t *inst);
+static void set_render_rate(nsaw_instance_t *inst, int render_rate);
 static void apply_preset(nsaw_instance_t *inst, int preset_idx);
+static void sync_smoothed_params(nsaw_instance_t *inst);
+static void publish_control(nsaw_instance_t *inst);
+static void consume_control(nsaw_instance_t *inst);
+static void reclaim_pools(nsaw_instance_t *inst);
 
 /* =====================================================================
  * Parameter application
  * ===================================================================== */
 
+/* Push the effective (smoothed) values into the engine.
+ * Called from the render loop once per control block. */
 static void apply_params_to_engine(nsaw_instance_t *inst) {
     nsaw_engine_t *e = &inst->engine;
+    const float *p = inst->smoothed;
+
+    e->cutoff      = p[P_CUTOFF];
+    e->resonance   = p[P_RESONANCE];
+    e->detune      = p[P_DETUNE];
+    e->spread      = p[P_SPREAD];
+    e->f_amount    = p[P_F_AMOUNT];
+    e->attack      = p[P_ATTACK];
+    e->decay       = p[P_DECAY];
+    e->sustain     = p[P_SUSTAIN];
+    e->release     = p[P_RELEASE];
+    e->f_attack    = p[P_F_ATTACK];
+    e->f_decay     = p[P_F_DECAY];
+    e->f_sustain   = p[P_F_SUSTAIN];
+    e->f_release   = p[P_F_RELEASE];
+    e->volume      = p[P_VOLUME];
+    e->vel_sens    = p[P_VEL_SENS];
+    e->bend_range  = p[P_BEND_RANGE];
+    e->sub_level   = p[P_SUB_LEVEL];
+    e->sub_octave  = (int)roundf(p[P_SUB_OCTAVE]);
+    e->osc_quality = (int)roundf(p[P_OSC_QUALITY]);
+    e->osc_mode    = (int)roundf(p[P_OSC_MODE]);
+    e->oversample  = (int)roundf(p[P_OVERSAMPLE]);
+
+    /* Polyphony: 0 = default */
+    int new_voices = (int)roundf(p[P_POLYPHONY]);
+    if (new_voices <= 0) new_voices = NSAW_DEFAULT_VOICES;
+    if (new_voices != e->num_voices) {
+        nsaw_engine_set_polyphony(e, new_voices);
+    }
 
-    e->cutoff      = inst->params[P_CUTOFF];
-    e->resonance   = inst->params[P_RESONANCE];
-    e->detune      = inst->params[P_DETUNE];
-    e->spread      = inst->params[P_SPREAD];
-    e->f_amount    = inst->params[P_F_AMOUNT];
-    e->attack      = inst->params[P_ATTACK];
-    e->decay       = inst->params[P_DECAY];
-    e->sustain     = inst->params[P_SUSTAIN];
-    e->release     = inst->params[P_RELEASE];
-    e->f_attack    = inst->params[P_F_ATTACK];
-    e->f_decay     = inst->params[P_F_DECAY];
-    e->f_sustain   = inst->params[P_F_SUSTAIN];
-    e->f_release   = inst->params[P_F_RELEASE];
-    e->volume      = inst->params[P_VOLUME];
-    e->vel_sens    = inst->params[P_VEL_SENS];
-    e->bend_range  = inst->params[P_BEND_RANGE];
-    e->sub_level   = inst->params[P_SUB_LEVEL];
-    e->sub_octave  = (int)roundf(inst->params[P_SUB_OCTAVE]);
-
-    int new_saw_count = (int)roundf(inst->params[P_SAW_COUNT]);
+    int new_saw_count = (int)roundf(p[P_SAW_COUNT]);
     new_saw_count |= 1;  /* ensure odd */
     if (new_saw_count != e->num_oscs) {
         nsaw_engine_update_osc_config(e, new_saw_count);
     }
+
+    /* Render rate: 0 = host rate, 1 = 2x */
+    int new_render_rate = (p[P_RENDER_RATE] >= 0.5f) ? 2 : 1;
+    if (new_render_rate != inst->render_rate) {
+        set_render_rate(inst, new_render_rate);
+    }
+}
+
+/* Run the engine at render_rate times the host rate. Smoothing steps once
+ * per engine control block, so its rate follows the engine's. */
+static void set_render_rate(nsaw_instance_t *inst, int render_rate) {
+    inst->render_rate = render_rate;
+    nsaw_engine_set_sample_rate(&inst->engine, inst->sample_rate * (float)render_rate);
+    nsaw_halfband_reset(&inst->down_l);
+    nsaw_halfband_reset(&inst->down_r);
+    param_helper_smooth_set_rate(g_shadow_params, PARAM_DEF_COUNT(g_shadow_params),
+                                 inst->smoothers,
+                                 inst->engine.sample_rate / inst->engine.control_block);
 }
 
 static void apply_preset(nsaw_instance_t *inst, int preset_idx) {
     if (preset_idx < 0 || preset_idx >= inst->preset_count) return;
 
+    /* The render rate is a CPU-for-quality choice of the setup, not part
+     * of the sound: a preset load keeps it */
     NsawPreset *p = &inst->presets[preset_idx];
-    memcpy(inst->params, p->params, sizeof(float) * P_COUNT);
+    float render_rate = inst->ctl.params[P_RENDER_RATE];
+    memcpy(inst->ctl.params, p->params, sizeof(float) * P_COUNT);
+    inst->ctl.params[P_RENDER_RATE] = render_rate;
     snprintf(inst->preset_name, sizeof(inst->preset_name), "%s", p->name);
     inst->current_preset = preset_idx;
+    /* Engine picks up the new values (with smoothing) on the next render
+     * after publish_control() */
+}
 
+/* Snap smoothers to the current targets and apply immediately (no glide).
+ * Used on instance creation and state restore. */
+static void sync_smoothed_params(nsaw_instance_t *inst) {
+    int count = (int)PARAM_DEF_COUNT(g_shadow_params);
+    param_helper_smooth_reset(g_shadow_params, count, inst->params, inst->smoothers);
+    param_helper_smooth_step(g_shadow_params, count, inst->params, inst->smoothers,
+                             inst->smoothed);
     apply_params_to_engine(inst);
 }
 
+/* Control thread: hand the current settings to the audio thread */
+static void publish_control(nsaw_instance_t *inst) {
+    int back = inst->ctl_tb.back;
+    memcpy(&inst->ctl_slots[back], &inst->ctl, sizeof(nsaw_settings_t));
+    nsaw_triple_buffer_publish(&inst->ctl_tb);
+}
+
+/* Control thread: free retired worker pools once the audio thread has
+ * acknowledged the latest switch */
+static void reclaim_pools(nsaw_instance_t *inst) {
+    if (inst->num_retired_pools == 0) return;
+    if (__atomic_load_n(&inst->pool_ack, __ATOMIC_ACQUIRE) != inst->ctl.pool_gen) return;
+    for (int i = 0; i < inst->num_retired_pools; i++)
+        nsaw_worker_pool_destroy(inst->retired_pools[i]);
+    inst->num_retired_pools = 0;
+}
+
+/* Audio thread, between blocks: apply the newest published settings */
+static void consume_control(nsaw_instance_t *inst) {
+    if (!nsaw_triple_buffer_acquire(&inst->ctl_tb)) return;
+    const nsaw_settings_t *c = &inst->ctl_slots[inst->ctl_tb.front];
+    nsaw_engine_t *e = &inst->engine;
+
+    memcpy(inst->params, c->params, sizeof(inst->params));
+    inst->octave_transpose = c->octave_transpose;
+    e->octave_transpose = c->octave_transpose;
+    if (c->control_block != e->control_block) {
+        nsaw_engine_set_control_block(e, c->control_block);
+        param_helper_smooth_set_rate(g_shadow_params, PARAM_DEF_COUNT(g_shadow_params),
+                                     inst->smoothers, e->sample_rate / e->control_block);
+    }
+    e->osc_kernel = c->osc_kernel;
+    e->phase_mode = c->phase_mode;
+    e->fast_paths = c->fast_paths;
+    e->unison_lod = c->unison_lod;
+    e->kernels = c->kernels;
+    inst->gov.target = c->cpu_target;
+
+    /* Not inside any pool between blocks: switch, then release the old */
+    if (c->pool_gen != __atomic_load_n(&inst->pool_ack, __ATOMIC_RELAXED)) {
+        nsaw_engine_set_worker_pool(e, c->pool);
+        __atomic_store_n(&inst->pool_ack, c->pool_gen, __ATOMIC_RELEASE);
+    }
+
+    if (c->notes_off != inst->notes_off_seen) {
+        inst->notes_off_seen = c->notes_off;
+        nsaw_engine_all_notes_off(e);
+    }
+    if (c->resync != inst->resync_seen) {
+        inst->resync_seen = c->resync;
+        sync_smoothed_params(inst);
+    }
+}
+
 /* =====================================================================
  * JSON helper
  * ===================================================================== */
@@ -527,13 +736,37 @@ static int json_get_number(const char *json, const char *key, float *out) {
 static void* v2_create_instance(const char *module_dir, const char *json_defaults) {
     (void)json_defaults;
 
-    nsaw_instance_t *inst = (nsaw_instance_t*)calloc(1, sizeof(nsaw_instance_t));
-    if (!inst) return NULL;
+    /* Cache-line aligned for the engine's voice pool */
+    void *mem = NULL;
+    if (posix_memalign(&mem, NSAW_CACHE_LINE, sizeof(nsaw_instance_t)) != 0) return NULL;
+    nsaw_instance_t *inst = (nsaw_instance_t*)mem;
+    memset(inst, 0, sizeof(nsaw_instance_t));
 
     strncpy(inst->module_dir, module_dir, sizeof(inst->module_dir) - 1);
 
-    /* Initialize engine */
+    /* Initialize engine at the host rate */
+    inst->sample_rate = (g_host && g_host->sample_rate > 0) ? (float)g_host->sample_rate
+                                                            : (float)MOVE_SAMPLE_RATE;
     nsaw_engine_init(&inst->engine);
+    inst->engine.kernels = g_kernels;
+    nsaw_midi_queue_reset(&inst->midi);
+
+    nsaw_governor_init(&inst->gov, NSAW_GOV_DEFAULT_TARGET, NSAW_DEGRADE_MAX);
+
+    /* Control settings start from the engine defaults */
+    nsaw_triple_buffer_init(&inst->ctl_tb);
+    inst->ctl.control_block = inst->engine.control_block;
+    inst->ctl.osc_kernel = inst->engine.osc_kernel;
+    inst->ctl.phase_mode = inst->engine.phase_mode;
+    inst->ctl.fast_paths = inst->engine.fast_paths;
+    inst->ctl.unison_lod = inst->engine.unison_lod;
+    inst->ctl.kernels = inst->engine.kernels;
+    inst->ctl.cpu_target = inst->gov.target;
+
+    /* Voices render on the audio thread until render_threads asks for
+     * workers: real-time threads are not the instance's to take */
+    inst->ctl.pool = NULL;
+    inst->ctl.pool_gen = 1;
 
     /* Load factory presets */
     inst->preset_count = FACTORY_PRESET_COUNT;
@@ -541,31 +774,51 @@ static void* v2_create_instance(const char *module_dir, const char *json_default
         memcpy(&inst->presets[i], &g_factory_presets[i], sizeof(NsawPreset));
     }
 
-    /* Initialize effects */
+    /* Initialize effects (chorus buffer: longest delay plus the
+     * interpolation tap, rounded up to a power of two) */
     memset(&inst->fx, 0, sizeof(nsaw_effects_t));
-    inst->fx.delay_buf_l = (float*)calloc(DELAY_MAX_SAMPLES, sizeof(float));
-    inst->fx.delay_buf_r = (float*)calloc(DELAY_MAX_SAMPLES, sizeof(float));
-
-    /* Apply first preset */
+    inst->fx.sample_rate = inst->sample_rate;
+    int chorus_min = (int)ceilf(CHORUS_MAX_DELAY_MS * inst->sample_rate / 1000.0f) + 2;
+    inst->fx.chorus_size = 1;
+    while (inst->fx.chorus_size < chorus_min) inst->fx.chorus_size <<= 1;
+    inst->fx.chorus_buf = (float*)calloc(inst->fx.chorus_size, sizeof(float));
+    inst->fx.delay_size = (int)(DELAY_MAX_SECONDS * inst->sample_rate);
+    inst->fx.delay_buf_l = (float*)calloc(inst->fx.delay_size, sizeof(float));
+    inst->fx.delay_buf_r = (float*)calloc(inst->fx.delay_size, sizeof(float));
+
+    /* Engine rate and control-rate smoothing */
+    set_render_rate(inst, 1);
+
+    /* Apply first preset (no render calls yet: take it over right here) */
     apply_preset(inst, 0);
-
-    plugin_log("NuSaw v2: Instance created (stereo + fx)");
+    inst->ctl.resync++;
+    publish_control(inst);
+    consume_control(inst);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "NuSaw v2: Instance created (stereo + fx, %d Hz, %d render threads)",
+             (int)inst->sample_rate, nsaw_worker_pool_threads(inst->ctl.pool));
+    plugin_log(msg);
     return inst;
 }
 
 static void v2_destroy_instance(void *instance) {
     nsaw_instance_t *inst = (nsaw_instance_t*)instance;
     if (!inst) return;
+    /* No render calls any more: every pool can go */
+    nsaw_worker_pool_destroy(inst->ctl.pool);
+    for (int i = 0; i < inst->num_retired_pools; i++)
+        nsaw_worker_pool_destroy(inst->retired_pools[i]);
+    free(inst->fx.chorus_buf);
     free(inst->fx.delay_buf_l);
     free(inst->fx.delay_buf_r);
     free(inst);
     plugin_log("NuSaw v2: Instance destroyed");
 }
 
-static void v2_on_midi(void *instance, const uint8_t *msg, int len, int source) {
-    nsaw_instance_t *inst = (nsaw_instance_t*)instance;
-    if (!inst || len < 2) return;
-    (void)source;
+/* Apply one MIDI message to the engine now */
+static void apply_midi(nsaw_instance_t *inst, const uint8_t *msg, int len) {
+    if (len < 2) return;
 
     uint8_t status = msg[0] & 0xF0;
     uint8_t data1 = msg[1];
@@ -597,9 +850,34 @@ static void v2_on_midi(void *instance, const uint8_t *msg, int len, int source)
     }
 }
 
+/* Queue a message for `frame` of the coming render calls. A full queue
+ * gives up timing, never order: the events due up to `frame` are applied
+ * now, in order, to make room; if none are, this message is the earliest
+ * and is applied now itself. */
+static void queue_midi(nsaw_instance_t *inst, const uint8_t *msg, int len, int frame) {
+    if (len < 2) return;
+    if (frame < 0) frame = 0;
+    if (nsaw_midi_queue_push(&inst->midi, (uint32_t)frame, msg, len) == 0) return;
+
+    const nsaw_midi_event_t *ev;
+    while ((ev = nsaw_midi_queue_due(&inst->midi, (uint32_t)frame)) != NULL)
+        apply_midi(inst, ev->msg, ev->len);
+    if (nsaw_midi_queue_push(&inst->midi, (uint32_t)frame, msg, len) != 0)
+        apply_midi(inst, msg, len);
+}
+
+static void v2_on_midi(void *instance, const uint8_t *msg, int len, int source) {
+    nsaw_instance_t *inst = (nsaw_instance_t*)instance;
+    if (!inst) return;
+    (void)source;
+    queue_midi(inst, msg, len, 0);
+}
+
 static void v2_set_param(void *instance, const char *key, const char *val) {
     nsaw_instance_t *inst = (nsaw_instance_t*)instance;
     if (!inst) return;
+    nsaw_settings_t *c = &inst->ctl;
+    reclaim_pools(inst);
 
     /* State restore from patch save */
     if (strcmp(key, "state") == 0) {
@@ -613,8 +891,7 @@ static void v2_set_param(void *instance, const char *key, const char *val) {
         }
 
         if (json_get_number(val, "octave_transpose", &fval) == 0) {
-            inst->octave_transpose = (int)fval;
-            inst->engine.octave_transpose = inst->octave_transpose;
+            c->octave_transpose = (int)fval;
         }
 
         /* Restore individual params */
@@ -622,10 +899,11 @@ static void v2_set_param(void *instance, const char *key, const char *val) {
             if (json_get_number(val, g_shadow_params[i].key, &fval) == 0) {
                 if (fval < g_shadow_params[i].min_val) fval = g_shadow_params[i].min_val;
                 if (fval > g_shadow_params[i].max_val) fval = g_shadow_params[i].max_val;
-                inst->params[g_shadow_params[i].index] = fval;
+                c->params[g_shadow_params[i].index] = fval;
             }
         }
-        apply_params_to_engine(inst);
+        c->resync++;
+        publish_control(inst);
         return;
     }
 
@@ -636,27 +914,81 @@ static void v2_set_param(void *instance, const char *key, const char *val) {
         }
     }
     else if (strcmp(key, "octave_transpose") == 0) {
-        inst->octave_transpose = atoi(val);
-        if (inst->octave_transpose < -3) inst->octave_transpose = -3;
-        if (inst->octave_transpose > 3) inst->octave_transpose = 3;
-        inst->engine.octave_transpose = inst->octave_transpose;
+        c->octave_transpose = atoi(val);
+        if (c->octave_transpose < -3) c->octave_transpose = -3;
+        if (c->octave_transpose > 3) c->octave_transpose = 3;
     }
     else if (strcmp(key, "all_notes_off") == 0) {
-        nsaw_engine_all_notes_off(&inst->engine);
+        c->notes_off++;
+    }
+    else if (strcmp(key, "control_block") == 0) {
+        /* Clamped as nsaw_engine_set_control_block() will */
+        int frames = atoi(val);
+        if (frames < NSAW_MIN_CONTROL_BLOCK) frames = NSAW_MIN_CONTROL_BLOCK;
+        if (frames > NSAW_MAX_RENDER) frames = NSAW_MAX_RENDER;
+        c->control_block = frames;
+    }
+    else if (strcmp(key, "osc_kernel") == 0) {
+        /* Oscillator bank A/B switch: 0 = scalar reference, 1 = SIMD per
+         * sample, 2 = SIMD per block, specialized per saw count */
+        int k = atoi(val);
+        c->osc_kernel = (k >= 2) ? NSAW_OSC_KERNEL_BLOCK :
+                        (k == 1) ? NSAW_OSC_KERNEL_SIMD : NSAW_OSC_KERNEL_SCALAR;
+    }
+    else if (strcmp(key, "phase_mode") == 0) {
+        /* Saw phase accumulator A/B switch: 0 = float, 1 = fixed-point */
+        c->phase_mode = atoi(val) ? NSAW_PHASE_FIXED : NSAW_PHASE_FLOAT;
+    }
+    else if (strcmp(key, "fast_paths") == 0) {
+        /* Feature-specialized voice kernels A/B switch: 0 = always run
+         * the full filter path */
+        c->fast_paths = atoi(val) ? 1 : 0;
+    }
+    else if (strcmp(key, "unison_lod") == 0) {
+        /* Unison level of detail A/B switch: 0 = always render every saw */
+        c->unison_lod = atoi(val) ? 1 : 0;
+    }
+    else if (strcmp(key, "render_threads") == 0) {
+        /* Worker thread count (default 0 = render on the audio thread
+         * only; nsaw_worker_pool_default_threads() suggests a count).
+         * The new pool's threads start here, off the audio thread; the
+         * old pool is retired until the audio thread has let go of it. */
+        if (inst->num_retired_pools == NSAW_MAX_RETIRED_POOLS) {
+            plugin_log("NuSaw v2: render_threads ignored, earlier changes still pending");
+            return;
+        }
+        if (c->pool) inst->retired_pools[inst->num_retired_pools++] = c->pool;
+        c->pool = nsaw_worker_pool_create(atoi(val));
+        c->pool_gen++;
+    }
+    else if (strcmp(key, "kernel_isa") == 0) {
+        /* Kernel ISA A/B switch: a table name from nusaw_kernels.h, falls
+         * back to the baseline build when unknown or unsupported here */
+        c->kernels = nsaw_kernels_select(val);
+    }
+    else if (strcmp(key, "cpu_target") == 0) {
+        /* Governor load target in percent of the block deadline (0 = off) */
+        float pct = (float)atof(val);
+        if (pct < 0.0f) pct = 0.0f;
+        if (pct > 100.0f) pct = 100.0f;
+        c->cpu_target = pct * 0.01f;
     }
     else {
         /* Named parameter access */
-        for (int i = 0; i < (int)PARAM_DEF_COUNT(g_shadow_params); i++) {
+        int i;
+        for (i = 0; i < (int)PARAM_DEF_COUNT(g_shadow_params); i++) {
             if (strcmp(key, g_shadow_params[i].key) == 0) {
                 float fval = (float)atof(val);
                 if (fval < g_shadow_params[i].min_val) fval = g_shadow_params[i].min_val;
                 if (fval > g_shadow_params[i].max_val) fval = g_shadow_params[i].max_val;
-                inst->params[g_shadow_params[i].index] = fval;
-                apply_params_to_engine(inst);
-                return;
+                c->params[g_shadow_params[i].index] = fval;
+                break;
             }
         }
+        if (i == (int)PARAM_DEF_COUNT(g_shadow_params)) return;
     }
+
+    publish_control(inst);
 }
 
 static int v2_get_param(void *instance, const char *key, char *buf, int buf_len) {
@@ -676,12 +1008,48 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
         return snprintf(buf, buf_len, "NuSaw");
     }
     if (strcmp(key, "octave_transpose") == 0) {
-        return snprintf(buf, buf_len, "%d", inst->octave_transpose);
+        return snprintf(buf, buf_len, "%d", inst->ctl.octave_transpose);
+    }
+    if (strcmp(key, "osc_kernel") == 0) {
+        return snprintf(buf, buf_len, "%d", inst->ctl.osc_kernel);
+    }
+    if (strcmp(key, "control_block") == 0) {
+        return snprintf(buf, buf_len, "%d", inst->ctl.control_block);
+    }
+    if (strcmp(key, "phase_mode") == 0) {
+        return snprintf(buf, buf_len, "%d", inst->ctl.phase_mode);
+    }
+    if (strcmp(key, "fast_paths") == 0) {
+        return snprintf(buf, buf_len, "%d", inst->ctl.fast_paths);
+    }
+    if (strcmp(key, "unison_lod") == 0) {
+        return snprintf(buf, buf_len, "%d", inst->ctl.unison_lod);
+    }
+    if (strcmp(key, "render_threads") == 0) {
+        return snprintf(buf, buf_len, "%d", nsaw_worker_pool_threads(inst->ctl.pool));
+    }
+    if (strcmp(key, "kernel_isa") == 0) {
+        return snprintf(buf, buf_len, "%s", inst->ctl.kernels->name);
+    }
+    if (strcmp(key, "cpu_target") == 0) {
+        return snprintf(buf, buf_len, "%d", (int)roundf(inst->ctl.cpu_target * 100.0f));
+    }
+    if (strcmp(key, "cpu_load") == 0) {
+        /* Read-only: smoothed render time in percent of the block deadline */
+        return snprintf(buf, buf_len, "%d", (int)roundf(inst->gov.load * 100.0f));
+    }
+    if (strcmp(key, "cpu_degrade") == 0) {
+        /* Read-only: governor degradation level (0 = full quality) */
+        return snprintf(buf, buf_len, "%d", inst->engine.degrade);
+    }
+    if (strcmp(key, "culled_voices") == 0) {
+        /* Read-only: voices skipped as silent in the last control block */
+        return snprintf(buf, buf_len, "%d", inst->engine.culled_voices);
     }
 
     /* Named parameter access via helper */
     int result = param_helper_get(g_shadow_params, PARAM_DEF_COUNT(g_shadow_params),
-                                  inst->params, key, buf, buf_len);
+                                  inst->ctl.params, key, buf, buf_len);
     if (result >= 0) return result;
 
     /* UI hierarchy for shadow parameter editor */
@@ -713,12 +1081,12 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
                 "\"oscillator\":{"
                     "\"children\":null,"
                     "\"knobs\":[\"detune\",\"spread\",\"saw_count\",\"sub_level\",\"sub_octave\"],"
-                    "\"params\":[\"detune\",\"spread\",\"saw_count\",\"sub_level\",\"sub_octave\"]"
+                    "\"params\":[\"detune\",\"spread\",\"saw_count\",\"sub_level\",\"sub_octave\",\"osc_mode\",\"osc_quality\"]"
                 "},"
                 "\"filter\":{"
                     "\"children\":null,"
                     "\"knobs\":[\"cutoff\",\"resonance\",\"f_amount\"],"
-                    "\"params\":[\"cutoff\",\"resonance\",\"f_amount\"]"
+                    "\"params\":[\"cutoff\",\"resonance\",\"f_amount\",\"oversample\"]"
                 "},"
                 "\"filt_env\":{"
                     "\"children\":null,"
@@ -743,7 +1111,7 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
                 "\"performance\":{"
                     "\"children\":null,"
                     "\"knobs\":[\"volume\",\"vel_sens\",\"bend_range\",\"octave_transpose\"],"
-                    "\"params\":[\"volume\",\"vel_sens\",\"bend_range\",\"octave_transpose\"]"
+                    "\"params\":[\"volume\",\"vel_sens\",\"bend_range\",\"octave_transpose\",\"polyphony\",\"render_rate\"]"
                 "}"
             "}"
         "}";
@@ -760,10 +1128,10 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
         int offset = 0;
         offset += snprintf(buf + offset, buf_len - offset,
             "{\"preset\":%d,\"octave_transpose\":%d",
-            inst->current_preset, inst->octave_transpose);
+            inst->current_preset, inst->ctl.octave_transpose);
 
         for (int i = 0; i < (int)PARAM_DEF_COUNT(g_shadow_params); i++) {
-            float val = inst->params[g_shadow_params[i].index];
+            float val = inst->ctl.params[g_shadow_params[i].index];
             offset += snprintf(buf + offset, buf_len - offset,
                 ",\"%s\":%.4f", g_shadow_params[i].key, val);
         }
@@ -797,6 +1165,12 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
 
 /* =====================================================================
  * Chorus processing (Juno-style)
+ *
+ * The effects stay scalar rather than on nusaw_simd.h: the chorus reads
+ * modulated, interpolated taps (a gather the layer does not have) and the
+ * delay's tone filter and feedback are per-sample recurrences, leaving
+ * only the two channels to run in parallel. Both are a small fixed cost
+ * next to the voices.
  * ===================================================================== */
 
 #ifndef M_PI
@@ -806,16 +1180,20 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
 static void process_chorus(nsaw_effects_t *fx, float *left, float *right, int frames,
                            float mix, float depth) {
     if (mix < 0.001f) return;
+    if (!fx->chorus_buf) return;
+
+    const int mask = fx->chorus_size - 1;
+    const float samples_per_ms = fx->sample_rate / 1000.0f;
 
     /* Juno-60 LFO rates */
     const float lfo1_rate = 0.513f;
     const float lfo2_rate = 0.863f;
-    const float lfo1_inc = lfo1_rate / 44100.0f;
-    const float lfo2_inc = lfo2_rate / 44100.0f;
+    const float lfo1_inc = lfo1_rate / fx->sample_rate;
+    const float lfo2_inc = lfo2_rate / fx->sample_rate;
 
-    /* Juno-60 delay range: 1.66ms to 5.35ms */
-    const float delay_center = (1.66f + 5.35f) * 0.5f * 44.1f;  /* ~154 samples */
-    const float delay_range = (5.35f - 1.66f) * 0.5f * 44.1f * depth;  /* ~81 samples * depth */
+    /* Juno-60 delay range: 1.66ms to 5.35ms (~154 +- 81 * depth samples at 44.1kHz) */
+    const float delay_center = (CHORUS_MIN_DELAY_MS + CHORUS_MAX_DELAY_MS) * 0.5f * samples_per_ms;
+    const float delay_range = (CHORUS_MAX_DELAY_MS - CHORUS_MIN_DELAY_MS) * 0.5f * samples_per_ms * depth;
 
     /* Equal-power crossfade coefficients */
     float dry_gain = sqrtf(1.0f - mix);
@@ -827,7 +1205,7 @@ static void process_chorus(nsaw_effects_t *fx, float *left, float *right, int fr
 
         /* Write to circular buffer */
         fx->chorus_buf[fx->chorus_write_pos] = mono_in;
-        fx->chorus_write_pos = (fx->chorus_write_pos + 1) & (CHORUS_BUF_SIZE - 1);
+        fx->chorus_write_pos = (fx->chorus_write_pos + 1) & mask;
 
         /* Triangle LFOs (0 to 1 range) */
         float tri1 = 2.0f * fabsf(2.0f * fx->lfo1_phase - 1.0f) - 1.0f;  /* -1 to 1 */
@@ -850,19 +1228,19 @@ static void process_chorus(nsaw_effects_t *fx, float *left, float *right, int fr
         /* Linear interpolation read from circular buffer */
         float read_pos_l = (float)fx->chorus_write_pos - delay_l;
         float read_pos_r = (float)fx->chorus_write_pos - delay_r;
-        if (read_pos_l < 0.0f) read_pos_l += CHORUS_BUF_SIZE;
-        if (read_pos_r < 0.0f) read_pos_r += CHORUS_BUF_SIZE;
+        if (read_pos_l < 0.0f) read_pos_l += fx->chorus_size;
+        if (read_pos_r < 0.0f) read_pos_r += fx->chorus_size;
 
         int idx_l = (int)read_pos_l;
         float frac_l = read_pos_l - idx_l;
-        int next_l = (idx_l + 1) & (CHORUS_BUF_SIZE - 1);
-        idx_l &= (CHORUS_BUF_SIZE - 1);
+        int next_l = (idx_l + 1) & mask;
+        idx_l &= mask;
         float wet_l = fx->chorus_buf[idx_l] + frac_l * (fx->chorus_buf[next_l] - fx->chorus_buf[idx_l]);
 
         int idx_r = (int)read_pos_r;
         float frac_r = read_pos_r - idx_r;
-        int next_r = (idx_r + 1) & (CHORUS_BUF_SIZE - 1);
-        idx_r &= (CHORUS_BUF_SIZE - 1);
+        int next_r = (idx_r + 1) & mask;
+        idx_r &= mask;
         float wet_r = fx->chorus_buf[idx_r] + frac_r * (fx->chorus_buf[next_r] - fx->chorus_buf[idx_r]);
 
         /* Equal-power mix */
@@ -883,8 +1261,8 @@ static void process_delay(nsaw_effects_t *fx, float *left, float *right, int fra
     /* Time: exponential mapping 20ms to 1000ms -> 20 * 50^p ms */
     float delay_ms = 20.0f * powf(50.0f, time_param);
     if (delay_ms > 1000.0f) delay_ms = 1000.0f;
-    float delay_samples = delay_ms * 44.1f;
-    if (delay_samples >= DELAY_MAX_SAMPLES - 1) delay_samples = DELAY_MAX_SAMPLES - 2;
+    float delay_samples = delay_ms * (fx->sample_rate / 1000.0f);
+    if (delay_samples >= fx->delay_size - 1) delay_samples = fx->delay_size - 2;
 
     /* Feedback capped at 95% */
     if (feedback > 0.95f) feedback = 0.95f;
@@ -892,18 +1270,18 @@ static void process_delay(nsaw_effects_t *fx, float *left, float *right, int fra
     /* Tone filter: one-pole lowpass, 500Hz to 12kHz */
     float tone_freq = 500.0f * powf(24.0f, tone_param);  /* 500 * 24^p */
     if (tone_freq > 12000.0f) tone_freq = 12000.0f;
-    float tone_coeff = 1.0f - expf(-2.0f * (float)M_PI * tone_freq / 44100.0f);
+    float tone_coeff = 1.0f - expf(-2.0f * (float)M_PI * tone_freq / fx->sample_rate);
 
     for (int i = 0; i < frames; i++) {
         /* Read from delay buffer with linear interpolation */
         float read_pos = (float)fx->delay_write_pos - delay_samples;
-        if (read_pos < 0.0f) read_pos += DELAY_MAX_SAMPLES;
+        if (read_pos < 0.0f) read_pos += fx->delay_size;
 
         int idx = (int)read_pos;
         float frac = read_pos - idx;
         int next = idx + 1;
-        if (next >= DELAY_MAX_SAMPLES) next = 0;
-        if (idx < 0) idx += DELAY_MAX_SAMPLES;
+        if (next >= fx->delay_size) next = 0;
+        if (idx < 0) idx += fx->delay_size;
 
         float tap_l = fx->delay_buf_l[idx] + frac * (fx->delay_buf_l[next] - fx->delay_buf_l[idx]);
         float tap_r = fx->delay_buf_r[idx] + frac * (fx->delay_buf_r[next] - fx->delay_buf_r[idx]);
@@ -919,25 +1297,95 @@ static void process_delay(nsaw_effects_t *fx, float *left, float *right, int fra
         float fb_r = right[i] + tap_l * feedback;
 
         /* Soft saturate feedback to prevent runaway */
-        if (fb_l > 1.0f || fb_l < -1.0f) fb_l = tanhf(fb_l);
-        if (fb_r > 1.0f || fb_r < -1.0f) fb_r = tanhf(fb_r);
+        if (fb_l > 1.0f || fb_l < -1.0f) fb_l = nsaw_tanhf(fb_l);
+        if (fb_r > 1.0f || fb_r < -1.0f) fb_r = nsaw_tanhf(fb_r);
 
-        /* Write to delay buffer */
-        fx->delay_buf_l[fx->delay_write_pos] = fb_l;
-        fx->delay_buf_r[fx->delay_write_pos] = fb_r;
+        /* Write to delay buffer (the feedback tail decays into it) */
+        fx->delay_buf_l[fx->delay_write_pos] = nsaw_flush_denormal(fb_l);
+        fx->delay_buf_r[fx->delay_write_pos] = nsaw_flush_denormal(fb_r);
         fx->delay_write_pos++;
-        if (fx->delay_write_pos >= DELAY_MAX_SAMPLES) fx->delay_write_pos = 0;
+        if (fx->delay_write_pos >= fx->delay_size) fx->delay_write_pos = 0;
 
         /* Mix: linear dry/wet */
         left[i]  = left[i]  * (1.0f - mix) + tap_l * mix;
         right[i] = right[i] * (1.0f - mix) + tap_r * mix;
     }
+
+    fx->tone_z1_l = nsaw_flush_denormal(fx->tone_z1_l);
+    fx->tone_z1_r = nsaw_flush_denormal(fx->tone_z1_r);
 }
 
 /* =====================================================================
  * Render
  * ===================================================================== */
 
+#define SOFT_CLIP_THRESHOLD 0.9f
+
+/* Render host-rate frames with the engine at 2x, decimating back through
+ * the halfband filter (passband to 0.4 x host rate) */
+static void render_engine_2x(nsaw_instance_t *inst, float *left, float *right, int frames) {
+    float l2[NSAW_MAX_RENDER], r2[NSAW_MAX_RENDER];
+    nsaw_engine_render(&inst->engine, l2, r2, frames * 2);
+    for (int i = 0; i < frames; i++) {
+        left[i] = nsaw_halfband_decimate(&inst->down_l, l2[2 * i], l2[2 * i + 1]);
+        right[i] = nsaw_halfband_decimate(&inst->down_r, r2[2 * i], r2[2 * i + 1]);
+    }
+}
+
+/* Engine output for frames [pos, pos + frames) of the render call,
+ * split at queued MIDI events so each one lands on its own frame. The
+ * engine keeps its control-block grid across the splits (ramps, drift and
+ * LOD fades run as if unsplit). */
+static void render_engine(nsaw_instance_t *inst, float *left, float *right, int pos, int frames) {
+    int n;
+    for (int done = 0; done < frames; done += n) {
+        uint32_t now = (uint32_t)(pos + done);
+        const nsaw_midi_event_t *ev;
+        while ((ev = nsaw_midi_queue_due(&inst->midi, now)) != NULL)
+            apply_midi(inst, ev->msg, ev->len);
+
+        n = frames - done;
+        uint32_t next = nsaw_midi_queue_next(&inst->midi);
+        if (next - now < (uint32_t)n) n = (int)(next - now);
+
+        if (inst->render_rate == 2) render_engine_2x(inst, left + done, right + done, n);
+        else nsaw_engine_render(&inst->engine, left + done, right + done, n);
+    }
+}
+
+/* Engine and effects for any number of frames, one engine control block
+ * at a time: step parameter smoothing, then render that block. pos is
+ * the frame of left[0] within the render call (for MIDI offsets). Float
+ * output before the output stage. */
+static void render_chain(nsaw_instance_t *inst, float *left, float *right, int pos, int frames) {
+    int n;
+    for (int start = 0; start < frames; start += n) {
+        param_helper_smooth_step(g_shadow_params, PARAM_DEF_COUNT(g_shadow_params),
+                                 inst->params, inst->smoothers, inst->smoothed);
+        apply_params_to_engine(inst);
+
+        n = inst->engine.control_block / inst->render_rate;
+        if (n > frames - start) n = frames - start;
+
+        float *l = left + start;
+        float *r = right + start;
+        render_engine(inst, l, r, pos + start, n);
+
+        /* Apply effects: chorus → delay */
+        process_chorus(&inst->fx, l, r, n,
+                       inst->smoothed[P_CHORUS_MIX], inst->smoothed[P_CHORUS_DEPTH]);
+        process_delay(&inst->fx, l, r, n,
+                      inst->smoothed[P_DELAY_TIME], inst->smoothed[P_DELAY_FBACK],
+                      inst->smoothed[P_DELAY_MIX], inst->smoothed[P_DELAY_TONE]);
+    }
+}
+
+/* Governor: trade quality for time before the deadline is missed */
+static void governor_update(nsaw_instance_t *inst, double t0, int frames) {
+    double deadline = (double)frames / (double)inst->sample_rate;
+    inst->engine.degrade = nsaw_governor_update(&inst->gov, nsaw_governor_now() - t0, deadline);
+}
+
 static void v2_render_block(void *instance, int16_t *out_interleaved_lr, int frames) {
     nsaw_instance_t *inst = (nsaw_instance_t*)instance;
     if (!inst) {
@@ -945,38 +1393,35 @@ static void v2_render_block(void *instance, int16_t *out_interleaved_lr, int fra
         return;
     }
 
-    /* Render stereo audio */
-    float left_buf[256], right_buf[256];
-    if (frames > 256) frames = 256;
+    double t0 = nsaw_governor_now();
 
-    nsaw_engine_render(&inst->engine, left_buf, right_buf, frames);
+    /* Decaying tails must not reach denormals (restored before return) */
+    nsaw_fp_scope_t fp_scope;
+    nsaw_fp_scope_enter(&fp_scope);
 
-    /* Apply effects: chorus → delay */
-    process_chorus(&inst->fx, left_buf, right_buf, frames,
-                   inst->params[P_CHORUS_MIX], inst->params[P_CHORUS_DEPTH]);
-    process_delay(&inst->fx, left_buf, right_buf, frames,
-                  inst->params[P_DELAY_TIME], inst->params[P_DELAY_FBACK],
-                  inst->params[P_DELAY_MIX], inst->params[P_DELAY_TONE]);
+    /* Settings from set_param take effect at the block boundary */
+    consume_control(inst);
 
-    /* Convert to interleaved int16 with soft clipping */
-    for (int i = 0; i < frames; i++) {
-        float l = left_buf[i];
-        float r = right_buf[i];
+    /* Any frame count, through a float buffer of whole control blocks (so
+     * the chunking does not move control block boundaries) */
+    float left_buf[NSAW_MAX_RENDER], right_buf[NSAW_MAX_RENDER];
+    int block = inst->engine.control_block / inst->render_rate;
+    int chunk = NSAW_MAX_RENDER - NSAW_MAX_RENDER % block;
+    int n;
+    for (int start = 0; start < frames; start += n) {
+        n = frames - start;
+        if (n > chunk) n = chunk;
 
-        /* Soft clip via tanh */
-        if (l > 0.9f || l < -0.9f) l = tanhf(l);
-        if (r > 0.9f || r < -0.9f) r = tanhf(r);
+        render_chain(inst, left_buf, right_buf, start, n);
 
-        int32_t sl = (int32_t)(l * 32767.0f);
-        int32_t sr_val = (int32_t)(r * 32767.0f);
-        if (sl > 32767) sl = 32767;
-        if (sl < -32768) sl = -32768;
-        if (sr_val > 32767) sr_val = 32767;
-        if (sr_val < -32768) sr_val = -32768;
-
-        out_interleaved_lr[i * 2]     = (int16_t)sl;
-        out_interleaved_lr[i * 2 + 1] = (int16_t)sr_val;
+        /* Soft clip via tanh and convert to interleaved int16 */
+        inst->engine.kernels->output(left_buf, right_buf, SOFT_CLIP_THRESHOLD,
+                                     out_interleaved_lr + start * 2, n);
     }
+    nsaw_midi_queue_end_block(&inst->midi, frames);
+
+    governor_update(inst, t0, frames);
+    nsaw_fp_scope_exit(&fp_scope);
 }
 
 static int v2_get_error(void *instance, char *buf, int buf_len) {
@@ -992,6 +1437,11 @@ static plugin_api_v2_t g_plugin_api_v2;
 extern "C" plugin_api_v2_t* move_plugin_init_v2(const host_api_v1_t *host) {
     g_host = host;
 
+    g_kernels = nsaw_kernels_select(NULL);
+    char msg[64];
+    snprintf(msg, sizeof(msg), "NuSaw v2: %s render kernels", g_kernels->name);
+    plugin_log(msg);
+
     memset(&g_plugin_api_v2, 0, sizeof(g_plugin_api_v2));
     g_plugin_api_v2.api_version = MOVE_PLUGIN_API_VERSION_2;
     g_plugin_api_v2.create_instance = v2_create_instance;
@@ -1004,3 +1454,58 @@ extern "C" plugin_api_v2_t* move_plugin_init_v2(const host_api_v1_t *host) {
 
     return &g_plugin_api_v2;
 }
+
+/* Offline float render (NSAW_RENDER_FLOAT_SYMBOL). Always full quality:
+ * the governor is not consulted, so a bounce does not depend on how long
+ * it took to render. */
+extern "C" void nsaw_render_float(void *instance, float *out_left, float *out_right, int frames) {
+    nsaw_instance_t *inst = (nsaw_instance_t*)instance;
+    if (!inst) {
+        memset(out_left, 0, frames * sizeof(float));
+        memset(out_right, 0, frames * sizeof(float));
+        return;
+    }
+
+    nsaw_fp_scope_t fp_scope;
+    nsaw_fp_scope_enter(&fp_scope);
+
+    consume_control(inst);
+    inst->engine.degrade = 0;
+    render_chain(inst, out_left, out_right, 0, frames);
+    nsaw_midi_queue_end_block(&inst->midi, frames);
+    nsaw_soft_clip_block(out_left, frames, SOFT_CLIP_THRESHOLD);
+    nsaw_soft_clip_block(out_right, frames, SOFT_CLIP_THRESHOLD);
+
+    nsaw_fp_scope_exit(&fp_scope);
+}
+
+/* Timestamped MIDI (NSAW_ON_MIDI_TIMED_SYMBOL) */
+extern "C" void nsaw_on_midi_timed(void *instance, const uint8_t *msg, int len,
+                                   int source, int frame) {
+    nsaw_instance_t *inst = (nsaw_instance_t*)instance;
+    if (!inst) return;
+    (void)source;
+    queue_midi(inst, msg, len, frame);
+}
+
+/* Packed bulk MIDI (NSAW_ON_MIDI_BULK_SYMBOL): [frame lo, frame hi,
+ * status, data...] records; stops at the first malformed record */
+extern "C" int nsaw_on_midi_bulk(void *instance, const uint8_t *buf, int len, int source) {
+    nsaw_instance_t *inst = (nsaw_instance_t*)instance;
+    if (!inst || !buf) return 0;
+    (void)source;
+
+    int queued = 0;
+    int i = 0;
+    while (i + 3 <= len) {
+        int frame = buf[i] | (buf[i + 1] << 8);
+        const uint8_t *msg = buf + i + 2;
+        if (msg[0] < 0x80 || msg[0] >= 0xF0) break;
+        int msg_len = ((msg[0] & 0xF0) == 0xC0 || (msg[0] & 0xF0) == 0xD0) ? 2 : 3;
+        if (i + 2 + msg_len > len) break;
+        queue_midi(inst, msg, msg_len, frame);
+        queued++;
+        i += 2 + msg_len;
+    }
+    return queued;
+}
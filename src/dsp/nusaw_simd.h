@@ -0,0 +1,350 @@
+/*
+ * nusaw_simd.h - Portable SIMD layer for the render path
+ *
+ * Fixed-width vector types and the handful of operations the oscillator
+ * bank, voice lanes, fast math kernels and output stage need:
+ *
+ *   nsaw_f4 / nsaw_f8   4 / 8 float lanes
+ *   nsaw_m4 / nsaw_m8   compare masks (all ones or all zeros per lane)
+ *   nsaw_i4 / nsaw_i8   32-bit integer lanes (wrapping add/sub, signed compare)
+ *
+ * Backends:
+ *
+ *   NSAW_SIMD_NEON    aarch64; 8 lanes as two 4-lane halves
+ *   NSAW_SIMD_SSE     x86 SSE2; 8 lanes as halves unless NSAW_SIMD_AVX
+ *   NSAW_SIMD_AVX     x86 AVX adds native 8-lane floats (integer lanes need
+ *                     AVX2, else they run as SSE2 halves)
+ *   NSAW_SIMD_SCALAR  plain arrays, one lane at a time
+ *
+ * The scalar backend is used when no vector ISA is available and can be
+ * forced with -DNSAW_SIMD_FORCE_SCALAR. Every backend computes each lane
+ * with the same IEEE operations in the same order, including the
+ * horizontal sums ((v0 + v2) + (v1 + v3) for 4 lanes, the 4-lane sum of
+ * lo + hi for 8), so a forced-scalar build reproduces a vector build of
+ * the same width bit for bit. Min/max follow SSE (second operand when
+ * either is NaN); they only ever see finite values here.
+ *
+ * NSAW_SIMD_WIDTH is the native width used by the lane primitives in
+ * nusaw_osc_bank.h: 8 with AVX, 4 otherwise. Override it (-DNSAW_SIMD_WIDTH=8)
+ * to run the 8-lane layout on another backend, e.g. to compare a scalar
+ * build against an AVX one.
+ */
+
+#ifndef NUSAW_SIMD_H
+#define NUSAW_SIMD_H
+
+#include <stdint.h>
+#include <math.h>
+
+#if defined(NSAW_SIMD_FORCE_SCALAR)
+#define NSAW_SIMD_SCALAR 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NSAW_SIMD_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define NSAW_SIMD_SSE 1
+#if defined(__AVX__)
+#include <immintrin.h>
+#define NSAW_SIMD_AVX 1
+#endif
+#else
+#define NSAW_SIMD_SCALAR 1
+#endif
+
+#ifndef NSAW_SIMD_WIDTH
+#if defined(NSAW_SIMD_AVX)
+#define NSAW_SIMD_WIDTH 8
+#else
+#define NSAW_SIMD_WIDTH 4
+#endif
+#endif
+
+/* Alignment for vector arrays (16 bytes = one 4-lane vector; 8-lane
+ * loads are unaligned so heap blocks from malloc are enough) */
+#define NSAW_ALIGN 16
+#define NSAW_ALIGNED __attribute__((aligned(NSAW_ALIGN)))
+
+/* =====================================================================
+ * 4 lanes
+ * ===================================================================== */
+
+#if defined(NSAW_SIMD_NEON)
+
+typedef float32x4_t nsaw_f4;
+typedef uint32x4_t nsaw_m4;
+typedef int32x4_t nsaw_i4;
+
+static inline nsaw_f4 nsaw_f4_load(const float *p)          { return vld1q_f32(p); }
+static inline void    nsaw_f4_store(float *p, nsaw_f4 v)    { vst1q_f32(p, v); }
+static inline nsaw_f4 nsaw_f4_set1(float x)                 { return vdupq_n_f32(x); }
+static inline nsaw_f4 nsaw_f4_add(nsaw_f4 a, nsaw_f4 b)     { return vaddq_f32(a, b); }
+static inline nsaw_f4 nsaw_f4_sub(nsaw_f4 a, nsaw_f4 b)     { return vsubq_f32(a, b); }
+static inline nsaw_f4 nsaw_f4_mul(nsaw_f4 a, nsaw_f4 b)     { return vmulq_f32(a, b); }
+static inline nsaw_f4 nsaw_f4_div(nsaw_f4 a, nsaw_f4 b)     { return vdivq_f32(a, b); }
+static inline nsaw_f4 nsaw_f4_max(nsaw_f4 a, nsaw_f4 b)     { return vmaxq_f32(a, b); }
+static inline nsaw_f4 nsaw_f4_min(nsaw_f4 a, nsaw_f4 b)     { return vminq_f32(a, b); }
+static inline nsaw_f4 nsaw_f4_abs(nsaw_f4 a)                { return vabsq_f32(a); }
+static inline nsaw_m4 nsaw_f4_eq(nsaw_f4 a, nsaw_f4 b)      { return vceqq_f32(a, b); }
+static inline nsaw_m4 nsaw_f4_ge(nsaw_f4 a, nsaw_f4 b)      { return vcgeq_f32(a, b); }
+static inline nsaw_m4 nsaw_f4_gt(nsaw_f4 a, nsaw_f4 b)      { return vcgtq_f32(a, b); }
+static inline nsaw_m4 nsaw_f4_lt(nsaw_f4 a, nsaw_f4 b)      { return vcltq_f32(a, b); }
+static inline nsaw_m4 nsaw_m4_and(nsaw_m4 a, nsaw_m4 b)     { return vandq_u32(a, b); }
+static inline nsaw_m4 nsaw_m4_andnot(nsaw_m4 a, nsaw_m4 b)  { return vbicq_u32(b, a); }  /* b & ~a */
+static inline nsaw_f4 nsaw_f4_masked(nsaw_m4 m, nsaw_f4 v)  {
+    return vreinterpretq_f32_u32(vandq_u32(m, vreinterpretq_u32_f32(v)));
+}
+static inline nsaw_f4 nsaw_f4_select(nsaw_m4 m, nsaw_f4 a, nsaw_f4 b) { return vbslq_f32(m, a, b); }
+static inline float nsaw_f4_hsum(nsaw_f4 v) {
+    float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vpadds_f32(s);
+}
+
+static inline nsaw_i4 nsaw_i4_load(const uint32_t *p)       { return vreinterpretq_s32_u32(vld1q_u32(p)); }
+static inline void    nsaw_i4_store(uint32_t *p, nsaw_i4 v) { vst1q_u32(p, vreinterpretq_u32_s32(v)); }
+static inline void    nsaw_i4_store_s(int32_t *p, nsaw_i4 v) { vst1q_s32(p, v); }
+static inline nsaw_i4 nsaw_i4_set1(uint32_t x)              { return vreinterpretq_s32_u32(vdupq_n_u32(x)); }
+static inline nsaw_i4 nsaw_i4_add(nsaw_i4 a, nsaw_i4 b)     { return vaddq_s32(a, b); }
+static inline nsaw_i4 nsaw_i4_sub(nsaw_i4 a, nsaw_i4 b)     { return vsubq_s32(a, b); }
+static inline nsaw_i4 nsaw_i4_shl(nsaw_i4 a, int n)         { return vshlq_s32(a, vdupq_n_s32(n)); }
+static inline nsaw_m4 nsaw_i4_lt(nsaw_i4 a, nsaw_i4 b)      { return vcltq_s32(a, b); }
+static inline nsaw_f4 nsaw_i4_to_f4(nsaw_i4 a)              { return vcvtq_f32_s32(a); }
+static inline nsaw_i4 nsaw_f4_to_i4(nsaw_f4 a)              { return vcvtq_s32_f32(a); }  /* truncate */
+static inline nsaw_f4 nsaw_i4_as_f4(nsaw_i4 a)              { return vreinterpretq_f32_s32(a); }
+
+#elif defined(NSAW_SIMD_SSE)
+
+typedef __m128 nsaw_f4;
+typedef __m128 nsaw_m4;
+typedef __m128i nsaw_i4;
+
+static inline nsaw_f4 nsaw_f4_load(const float *p)          { return _mm_loadu_ps(p); }
+static inline void    nsaw_f4_store(float *p, nsaw_f4 v)    { _mm_storeu_ps(p, v); }
+static inline nsaw_f4 nsaw_f4_set1(float x)                 { return _mm_set1_ps(x); }
+static inline nsaw_f4 nsaw_f4_add(nsaw_f4 a, nsaw_f4 b)     { return _mm_add_ps(a, b); }
+static inline nsaw_f4 nsaw_f4_sub(nsaw_f4 a, nsaw_f4 b)     { return _mm_sub_ps(a, b); }
+static inline nsaw_f4 nsaw_f4_mul(nsaw_f4 a, nsaw_f4 b)     { return _mm_mul_ps(a, b); }
+static inline nsaw_f4 nsaw_f4_div(nsaw_f4 a, nsaw_f4 b)     { return _mm_div_ps(a, b); }
+static inline nsaw_f4 nsaw_f4_max(nsaw_f4 a, nsaw_f4 b)     { return _mm_max_ps(a, b); }
+static inline nsaw_f4 nsaw_f4_min(nsaw_f4 a, nsaw_f4 b)     { return _mm_min_ps(a, b); }
+static inline nsaw_f4 nsaw_f4_abs(nsaw_f4 a) {
+    return _mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)));
+}
+static inline nsaw_m4 nsaw_f4_eq(nsaw_f4 a, nsaw_f4 b)      { return _mm_cmpeq_ps(a, b); }
+static inline nsaw_m4 nsaw_f4_ge(nsaw_f4 a, nsaw_f4 b)      { return _mm_cmpge_ps(a, b); }
+static inline nsaw_m4 nsaw_f4_gt(nsaw_f4 a, nsaw_f4 b)      { return _mm_cmpgt_ps(a, b); }
+static inline nsaw_m4 nsaw_f4_lt(nsaw_f4 a, nsaw_f4 b)      { return _mm_cmplt_ps(a, b); }
+static inline nsaw_m4 nsaw_m4_and(nsaw_m4 a, nsaw_m4 b)     { return _mm_and_ps(a, b); }
+static inline nsaw_m4 nsaw_m4_andnot(nsaw_m4 a, nsaw_m4 b)  { return _mm_andnot_ps(a, b); }
+static inline nsaw_f4 nsaw_f4_masked(nsaw_m4 m, nsaw_f4 v)  { return _mm_and_ps(m, v); }
+static inline nsaw_f4 nsaw_f4_select(nsaw_m4 m, nsaw_f4 a, nsaw_f4 b) {
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+}
+static inline float nsaw_f4_hsum(nsaw_f4 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 1)));
+}
+
+static inline nsaw_i4 nsaw_i4_load(const uint32_t *p)       { return _mm_loadu_si128((const __m128i*)p); }
+static inline void    nsaw_i4_store(uint32_t *p, nsaw_i4 v) { _mm_storeu_si128((__m128i*)p, v); }
+static inline void    nsaw_i4_store_s(int32_t *p, nsaw_i4 v) { _mm_storeu_si128((__m128i*)p, v); }
+static inline nsaw_i4 nsaw_i4_set1(uint32_t x)              { return _mm_set1_epi32((int)x); }
+static inline nsaw_i4 nsaw_i4_add(nsaw_i4 a, nsaw_i4 b)     { return _mm_add_epi32(a, b); }
+static inline nsaw_i4 nsaw_i4_sub(nsaw_i4 a, nsaw_i4 b)     { return _mm_sub_epi32(a, b); }
+static inline nsaw_i4 nsaw_i4_shl(nsaw_i4 a, int n)         { return _mm_slli_epi32(a, n); }
+static inline nsaw_m4 nsaw_i4_lt(nsaw_i4 a, nsaw_i4 b)      { return _mm_castsi128_ps(_mm_cmplt_epi32(a, b)); }
+static inline nsaw_f4 nsaw_i4_to_f4(nsaw_i4 a)              { return _mm_cvtepi32_ps(a); }
+static inline nsaw_i4 nsaw_f4_to_i4(nsaw_f4 a)              { return _mm_cvttps_epi32(a); }  /* truncate */
+static inline nsaw_f4 nsaw_i4_as_f4(nsaw_i4 a)              { return _mm_castsi128_ps(a); }
+
+#else /* NSAW_SIMD_SCALAR */
+
+typedef struct { float v[4]; } nsaw_f4;
+typedef struct { uint32_t v[4]; } nsaw_m4;
+typedef struct { int32_t v[4]; } nsaw_i4;
+
+#define NSAW_F4_MAP(expr) { nsaw_f4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r; }
+#define NSAW_M4_MAP(expr) { nsaw_m4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr) ? 0xFFFFFFFFu : 0u; return r; }
+#define NSAW_I4_MAP(expr) { nsaw_i4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r; }
+
+static inline nsaw_f4 nsaw_f4_load(const float *p)          NSAW_F4_MAP(p[i])
+static inline void    nsaw_f4_store(float *p, nsaw_f4 a)    { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+static inline nsaw_f4 nsaw_f4_set1(float x)                 NSAW_F4_MAP(x)
+static inline nsaw_f4 nsaw_f4_add(nsaw_f4 a, nsaw_f4 b)     NSAW_F4_MAP(a.v[i] + b.v[i])
+static inline nsaw_f4 nsaw_f4_sub(nsaw_f4 a, nsaw_f4 b)     NSAW_F4_MAP(a.v[i] - b.v[i])
+static inline nsaw_f4 nsaw_f4_mul(nsaw_f4 a, nsaw_f4 b)     NSAW_F4_MAP(a.v[i] * b.v[i])
+static inline nsaw_f4 nsaw_f4_div(nsaw_f4 a, nsaw_f4 b)     NSAW_F4_MAP(a.v[i] / b.v[i])
+static inline nsaw_f4 nsaw_f4_max(nsaw_f4 a, nsaw_f4 b)     NSAW_F4_MAP(a.v[i] > b.v[i] ? a.v[i] : b.v[i])
+static inline nsaw_f4 nsaw_f4_min(nsaw_f4 a, nsaw_f4 b)     NSAW_F4_MAP(a.v[i] < b.v[i] ? a.v[i] : b.v[i])
+static inline nsaw_f4 nsaw_f4_abs(nsaw_f4 a)                NSAW_F4_MAP(fabsf(a.v[i]))
+static inline nsaw_m4 nsaw_f4_eq(nsaw_f4 a, nsaw_f4 b)      NSAW_M4_MAP(a.v[i] == b.v[i])
+static inline nsaw_m4 nsaw_f4_ge(nsaw_f4 a, nsaw_f4 b)      NSAW_M4_MAP(a.v[i] >= b.v[i])
+static inline nsaw_m4 nsaw_f4_gt(nsaw_f4 a, nsaw_f4 b)      NSAW_M4_MAP(a.v[i] > b.v[i])
+static inline nsaw_m4 nsaw_f4_lt(nsaw_f4 a, nsaw_f4 b)      NSAW_M4_MAP(a.v[i] < b.v[i])
+static inline nsaw_m4 nsaw_m4_and(nsaw_m4 a, nsaw_m4 b)     NSAW_M4_MAP(a.v[i] & b.v[i])
+static inline nsaw_m4 nsaw_m4_andnot(nsaw_m4 a, nsaw_m4 b)  NSAW_M4_MAP(~a.v[i] & b.v[i])
+static inline nsaw_f4 nsaw_f4_masked(nsaw_m4 m, nsaw_f4 a)  NSAW_F4_MAP(m.v[i] ? a.v[i] : 0.0f)
+static inline nsaw_f4 nsaw_f4_select(nsaw_m4 m, nsaw_f4 a, nsaw_f4 b) NSAW_F4_MAP(m.v[i] ? a.v[i] : b.v[i])
+static inline float nsaw_f4_hsum(nsaw_f4 a) {
+    return (a.v[0] + a.v[2]) + (a.v[1] + a.v[3]);
+}
+
+static inline nsaw_i4 nsaw_i4_load(const uint32_t *p)       NSAW_I4_MAP((int32_t)p[i])
+static inline void    nsaw_i4_store(uint32_t *p, nsaw_i4 a) { for (int i = 0; i < 4; i++) p[i] = (uint32_t)a.v[i]; }
+static inline void    nsaw_i4_store_s(int32_t *p, nsaw_i4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+static inline nsaw_i4 nsaw_i4_set1(uint32_t x)              NSAW_I4_MAP((int32_t)x)
+static inline nsaw_i4 nsaw_i4_add(nsaw_i4 a, nsaw_i4 b)     NSAW_I4_MAP((int32_t)((uint32_t)a.v[i] + (uint32_t)b.v[i]))
+static inline nsaw_i4 nsaw_i4_sub(nsaw_i4 a, nsaw_i4 b)     NSAW_I4_MAP((int32_t)((uint32_t)a.v[i] - (uint32_t)b.v[i]))
+static inline nsaw_i4 nsaw_i4_shl(nsaw_i4 a, int n)         NSAW_I4_MAP((int32_t)((uint32_t)a.v[i] << n))
+static inline nsaw_m4 nsaw_i4_lt(nsaw_i4 a, nsaw_i4 b)      NSAW_M4_MAP(a.v[i] < b.v[i])
+static inline nsaw_f4 nsaw_i4_to_f4(nsaw_i4 a)              NSAW_F4_MAP((float)a.v[i])
+static inline nsaw_i4 nsaw_f4_to_i4(nsaw_f4 a)              NSAW_I4_MAP((int32_t)a.v[i])  /* truncate */
+static inline nsaw_f4 nsaw_i4_as_f4(nsaw_i4 a) {
+    union { int32_t i[4]; float f[4]; } u;
+    for (int i = 0; i < 4; i++) u.i[i] = a.v[i];
+    return nsaw_f4_load(u.f);
+}
+
+#undef NSAW_F4_MAP
+#undef NSAW_M4_MAP
+#undef NSAW_I4_MAP
+
+#endif
+
+/* Round to nearest, ties away from zero (x + copysign(0.5, x), truncated),
+ * as the scalar kernels in nusaw_fastmath.h do */
+static inline nsaw_i4 nsaw_f4_round(nsaw_f4 x) {
+    nsaw_f4 half = nsaw_f4_select(nsaw_f4_ge(x, nsaw_f4_set1(0.0f)),
+                                  nsaw_f4_set1(0.5f), nsaw_f4_set1(-0.5f));
+    return nsaw_f4_to_i4(nsaw_f4_add(x, half));
+}
+
+/* =====================================================================
+ * 8 lanes
+ * ===================================================================== */
+
+#if defined(NSAW_SIMD_AVX)
+
+typedef __m256 nsaw_f8;
+typedef __m256 nsaw_m8;
+typedef __m256i nsaw_i8;
+
+static inline nsaw_f8 nsaw_f8_load(const float *p)          { return _mm256_loadu_ps(p); }
+static inline void    nsaw_f8_store(float *p, nsaw_f8 v)    { _mm256_storeu_ps(p, v); }
+static inline nsaw_f8 nsaw_f8_set1(float x)                 { return _mm256_set1_ps(x); }
+static inline nsaw_f8 nsaw_f8_add(nsaw_f8 a, nsaw_f8 b)     { return _mm256_add_ps(a, b); }
+static inline nsaw_f8 nsaw_f8_sub(nsaw_f8 a, nsaw_f8 b)     { return _mm256_sub_ps(a, b); }
+static inline nsaw_f8 nsaw_f8_mul(nsaw_f8 a, nsaw_f8 b)     { return _mm256_mul_ps(a, b); }
+static inline nsaw_f8 nsaw_f8_div(nsaw_f8 a, nsaw_f8 b)     { return _mm256_div_ps(a, b); }
+static inline nsaw_f8 nsaw_f8_max(nsaw_f8 a, nsaw_f8 b)     { return _mm256_max_ps(a, b); }
+static inline nsaw_f8 nsaw_f8_min(nsaw_f8 a, nsaw_f8 b)     { return _mm256_min_ps(a, b); }
+static inline nsaw_f8 nsaw_f8_abs(nsaw_f8 a) {
+    return _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)));
+}
+static inline nsaw_m8 nsaw_f8_eq(nsaw_f8 a, nsaw_f8 b)      { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+static inline nsaw_m8 nsaw_f8_ge(nsaw_f8 a, nsaw_f8 b)      { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+static inline nsaw_m8 nsaw_f8_gt(nsaw_f8 a, nsaw_f8 b)      { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline nsaw_m8 nsaw_f8_lt(nsaw_f8 a, nsaw_f8 b)      { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline nsaw_m8 nsaw_m8_and(nsaw_m8 a, nsaw_m8 b)     { return _mm256_and_ps(a, b); }
+static inline nsaw_m8 nsaw_m8_andnot(nsaw_m8 a, nsaw_m8 b)  { return _mm256_andnot_ps(a, b); }
+static inline nsaw_f8 nsaw_f8_masked(nsaw_m8 m, nsaw_f8 v)  { return _mm256_and_ps(m, v); }
+static inline nsaw_f8 nsaw_f8_select(nsaw_m8 m, nsaw_f8 a, nsaw_f8 b) { return _mm256_blendv_ps(b, a, m); }
+static inline nsaw_f4 nsaw_f8_lo(nsaw_f8 v)                 { return _mm256_castps256_ps128(v); }
+static inline nsaw_f4 nsaw_f8_hi(nsaw_f8 v)                 { return _mm256_extractf128_ps(v, 1); }
+static inline nsaw_f8 nsaw_f8_join(nsaw_f4 lo, nsaw_f4 hi) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+static inline nsaw_i8 nsaw_i8_load(const uint32_t *p)       { return _mm256_loadu_si256((const __m256i*)p); }
+static inline void    nsaw_i8_store(uint32_t *p, nsaw_i8 v) { _mm256_storeu_si256((__m256i*)p, v); }
+static inline nsaw_i8 nsaw_i8_set1(uint32_t x)              { return _mm256_set1_epi32((int)x); }
+static inline nsaw_f8 nsaw_i8_to_f8(nsaw_i8 a)              { return _mm256_cvtepi32_ps(a); }
+#ifdef __AVX2__
+static inline nsaw_i8 nsaw_i8_add(nsaw_i8 a, nsaw_i8 b)     { return _mm256_add_epi32(a, b); }
+static inline nsaw_i8 nsaw_i8_sub(nsaw_i8 a, nsaw_i8 b)     { return _mm256_sub_epi32(a, b); }
+static inline nsaw_m8 nsaw_i8_lt(nsaw_i8 a, nsaw_i8 b)      { return _mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a)); }
+#else
+/* AVX1 has no 256-bit integer ops: run both 128-bit halves */
+#define NSAW_AVX_HALVES(op, a, b) \
+    _mm256_insertf128_si256(_mm256_castsi128_si256(op(_mm256_castsi256_si128(a), \
+                                                      _mm256_castsi256_si128(b))), \
+                            op(_mm256_extractf128_si256(a, 1), _mm256_extractf128_si256(b, 1)), 1)
+static inline nsaw_i8 nsaw_i8_add(nsaw_i8 a, nsaw_i8 b)     { return NSAW_AVX_HALVES(_mm_add_epi32, a, b); }
+static inline nsaw_i8 nsaw_i8_sub(nsaw_i8 a, nsaw_i8 b)     { return NSAW_AVX_HALVES(_mm_sub_epi32, a, b); }
+static inline nsaw_m8 nsaw_i8_lt(nsaw_i8 a, nsaw_i8 b)      {
+    return _mm256_castsi256_ps(NSAW_AVX_HALVES(_mm_cmpgt_epi32, b, a));
+}
+#undef NSAW_AVX_HALVES
+#endif
+
+#else /* two 4-lane halves */
+
+typedef struct { nsaw_f4 lo, hi; } nsaw_f8;
+typedef struct { nsaw_m4 lo, hi; } nsaw_m8;
+typedef struct { nsaw_i4 lo, hi; } nsaw_i8;
+
+static inline nsaw_f8 nsaw_f8_load(const float *p) {
+    nsaw_f8 r; r.lo = nsaw_f4_load(p); r.hi = nsaw_f4_load(p + 4); return r;
+}
+static inline void nsaw_f8_store(float *p, nsaw_f8 v) {
+    nsaw_f4_store(p, v.lo); nsaw_f4_store(p + 4, v.hi);
+}
+static inline nsaw_f8 nsaw_f8_set1(float x) {
+    nsaw_f8 r; r.lo = r.hi = nsaw_f4_set1(x); return r;
+}
+
+#define NSAW_F8_BINARY(name, R, A, B, op) \
+    static inline R name(A a, B b) { R r; r.lo = op(a.lo, b.lo); r.hi = op(a.hi, b.hi); return r; }
+
+NSAW_F8_BINARY(nsaw_f8_add, nsaw_f8, nsaw_f8, nsaw_f8, nsaw_f4_add)
+NSAW_F8_BINARY(nsaw_f8_sub, nsaw_f8, nsaw_f8, nsaw_f8, nsaw_f4_sub)
+NSAW_F8_BINARY(nsaw_f8_mul, nsaw_f8, nsaw_f8, nsaw_f8, nsaw_f4_mul)
+NSAW_F8_BINARY(nsaw_f8_div, nsaw_f8, nsaw_f8, nsaw_f8, nsaw_f4_div)
+NSAW_F8_BINARY(nsaw_f8_max, nsaw_f8, nsaw_f8, nsaw_f8, nsaw_f4_max)
+NSAW_F8_BINARY(nsaw_f8_min, nsaw_f8, nsaw_f8, nsaw_f8, nsaw_f4_min)
+NSAW_F8_BINARY(nsaw_f8_eq, nsaw_m8, nsaw_f8, nsaw_f8, nsaw_f4_eq)
+NSAW_F8_BINARY(nsaw_f8_ge, nsaw_m8, nsaw_f8, nsaw_f8, nsaw_f4_ge)
+NSAW_F8_BINARY(nsaw_f8_gt, nsaw_m8, nsaw_f8, nsaw_f8, nsaw_f4_gt)
+NSAW_F8_BINARY(nsaw_f8_lt, nsaw_m8, nsaw_f8, nsaw_f8, nsaw_f4_lt)
+NSAW_F8_BINARY(nsaw_m8_and, nsaw_m8, nsaw_m8, nsaw_m8, nsaw_m4_and)
+NSAW_F8_BINARY(nsaw_m8_andnot, nsaw_m8, nsaw_m8, nsaw_m8, nsaw_m4_andnot)
+NSAW_F8_BINARY(nsaw_f8_masked, nsaw_f8, nsaw_m8, nsaw_f8, nsaw_f4_masked)
+NSAW_F8_BINARY(nsaw_i8_add, nsaw_i8, nsaw_i8, nsaw_i8, nsaw_i4_add)
+NSAW_F8_BINARY(nsaw_i8_sub, nsaw_i8, nsaw_i8, nsaw_i8, nsaw_i4_sub)
+NSAW_F8_BINARY(nsaw_i8_lt, nsaw_m8, nsaw_i8, nsaw_i8, nsaw_i4_lt)
+
+#undef NSAW_F8_BINARY
+
+static inline nsaw_f8 nsaw_f8_abs(nsaw_f8 a) {
+    nsaw_f8 r; r.lo = nsaw_f4_abs(a.lo); r.hi = nsaw_f4_abs(a.hi); return r;
+}
+static inline nsaw_f8 nsaw_f8_select(nsaw_m8 m, nsaw_f8 a, nsaw_f8 b) {
+    nsaw_f8 r;
+    r.lo = nsaw_f4_select(m.lo, a.lo, b.lo);
+    r.hi = nsaw_f4_select(m.hi, a.hi, b.hi);
+    return r;
+}
+static inline nsaw_f4 nsaw_f8_lo(nsaw_f8 v)                 { return v.lo; }
+static inline nsaw_f4 nsaw_f8_hi(nsaw_f8 v)                 { return v.hi; }
+static inline nsaw_f8 nsaw_f8_join(nsaw_f4 lo, nsaw_f4 hi)  { nsaw_f8 r; r.lo = lo; r.hi = hi; return r; }
+
+static inline nsaw_i8 nsaw_i8_load(const uint32_t *p) {
+    nsaw_i8 r; r.lo = nsaw_i4_load(p); r.hi = nsaw_i4_load(p + 4); return r;
+}
+static inline void nsaw_i8_store(uint32_t *p, nsaw_i8 v) {
+    nsaw_i4_store(p, v.lo); nsaw_i4_store(p + 4, v.hi);
+}
+static inline nsaw_i8 nsaw_i8_set1(uint32_t x) {
+    nsaw_i8 r; r.lo = r.hi = nsaw_i4_set1(x); return r;
+}
+static inline nsaw_f8 nsaw_i8_to_f8(nsaw_i8 a) {
+    nsaw_f8 r; r.lo = nsaw_i4_to_f4(a.lo); r.hi = nsaw_i4_to_f4(a.hi); return r;
+}
+
+#endif
+
+static inline float nsaw_f8_hsum(nsaw_f8 v) {
+    return nsaw_f4_hsum(nsaw_f4_add(nsaw_f8_lo(v), nsaw_f8_hi(v)));
+}
+
+#endif /* NUSAW_SIMD_H */
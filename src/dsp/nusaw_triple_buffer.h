@@ -0,0 +1,55 @@
+/*
+ * nusaw_triple_buffer.h - Lock-free single-writer/single-reader snapshot
+ *
+ * Hands whole structs from one thread to another without locks and
+ * without either side ever waiting. The caller owns three slots of its
+ * type; this tracks which slot each side may touch:
+ *
+ *   back    the writer's slot: fill it, then nsaw_triple_buffer_publish()
+ *   middle  the latest published slot, not yet taken by the reader
+ *   front   the reader's slot: nsaw_triple_buffer_acquire() swaps in the
+ *           middle one when something new was published
+ *
+ * Each publish/acquire is one atomic exchange. The reader always sees a
+ * complete slot, the newest one published; intermediate publishes it did
+ * not get to are skipped, so only state (not events) belongs in a slot.
+ */
+
+#ifndef NUSAW_TRIPLE_BUFFER_H
+#define NUSAW_TRIPLE_BUFFER_H
+
+#define NSAW_TRIPLE_BUFFER_FRESH 4  /* middle flag: published since last acquire */
+
+typedef struct {
+    int back;           /* writer side */
+    int middle;         /* atomic: slot index | NSAW_TRIPLE_BUFFER_FRESH */
+    int front;          /* reader side */
+} nsaw_triple_buffer_t;
+
+static inline void nsaw_triple_buffer_init(nsaw_triple_buffer_t *tb) {
+    tb->back = 0;
+    tb->middle = 1;
+    tb->front = 2;
+}
+
+/* Writer: the back slot is complete. Returns the new back slot, which
+ * holds stale contents (the writer refills it in full before the next
+ * publish). */
+static inline int nsaw_triple_buffer_publish(nsaw_triple_buffer_t *tb) {
+    int old = __atomic_exchange_n(&tb->middle, tb->back | NSAW_TRIPLE_BUFFER_FRESH,
+                                  __ATOMIC_ACQ_REL);
+    tb->back = old & 3;
+    return tb->back;
+}
+
+/* Reader: take the newest published slot if there is one. Returns 1 if
+ * tb->front changed. */
+static inline int nsaw_triple_buffer_acquire(nsaw_triple_buffer_t *tb) {
+    if (!(__atomic_load_n(&tb->middle, __ATOMIC_RELAXED) & NSAW_TRIPLE_BUFFER_FRESH))
+        return 0;
+    int old = __atomic_exchange_n(&tb->middle, tb->front, __ATOMIC_ACQ_REL);
+    tb->front = old & 3;
+    return 1;
+}
+
+#endif /* NUSAW_TRIPLE_BUFFER_H */
@@ -0,0 +1,211 @@
+/*
+ * nusaw_worker_pool.cpp - Real-time worker threads for parallel voice rendering
+ *
+ * Batch protocol:
+ *   caller   publish fn/ctx, then the claim word for a new generation,
+ *            wake N workers (semaphore), claim jobs itself, then spin
+ *            until every job is done
+ *   worker   sleep on its semaphore, claim jobs until the batch runs out,
+ *            sleep again
+ *
+ * The claim word packs generation, job count and next job, and a job is
+ * claimed by compare-and-swap on the whole word. A worker that wakes late
+ * (or for a post left over from an earlier batch) therefore either claims
+ * a job of the batch that is current or finds nothing; it can never take
+ * a job of the next batch against the previous one's count. The caller
+ * waits only for jobs already claimed, not for workers to wake.
+ */
+
+#include "nusaw_worker_pool.h"
+#include "nusaw_denormal.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NSAW_WORKER_SPIN_LIMIT 4096  /* busy-wait iterations before yielding */
+
+struct nsaw_worker {
+    struct nsaw_worker_pool *pool;
+    pthread_t thread;
+    sem_t wake;
+    int cpu;
+};
+
+struct nsaw_worker_pool {
+    struct nsaw_worker workers[NSAW_MAX_WORKERS];
+    int num_workers;
+    int rt_priority;    /* SCHED_FIFO priority for the workers */
+
+    /* Current batch (written by the caller before publishing claim) */
+    nsaw_job_fn fn;
+    void *ctx;
+
+    uint64_t claim;     /* atomic: generation << 32 | num_jobs << 16 | next job */
+    uint32_t generation;
+    int jobs_done;      /* atomic: finished jobs of the current batch */
+    int quit;           /* atomic */
+};
+
+#define CLAIM_JOBS(c) ((int)(((c) >> 16) & 0xFFFF))
+#define CLAIM_NEXT(c) ((int)((c) & 0xFFFF))
+
+static inline void cpu_relax(void) {
+#if defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/* Claim and run jobs of the current batch until none are left. A claimed
+ * job keeps the caller waiting, so fn/ctx cannot change under it. */
+static void run_jobs(struct nsaw_worker_pool *pool) {
+    uint64_t c = __atomic_load_n(&pool->claim, __ATOMIC_ACQUIRE);
+    for (;;) {
+        if (CLAIM_NEXT(c) >= CLAIM_JOBS(c)) break;
+        if (!__atomic_compare_exchange_n(&pool->claim, &c, c + 1, 0,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            continue;   /* c reloaded */
+        pool->fn(pool->ctx, CLAIM_NEXT(c));
+        __atomic_fetch_add(&pool->jobs_done, 1, __ATOMIC_RELEASE);
+        c++;
+    }
+}
+
+/* Pin to one core and raise to SCHED_FIFO; failures (no permission,
+ * fewer cores) leave the thread at normal priority. Workers only ever
+ * render, so they flush denormals for their whole lifetime. */
+static void setup_worker_thread(struct nsaw_worker *w) {
+    nsaw_fp_scope_t fp_scope;
+    nsaw_fp_scope_enter(&fp_scope);
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(w->cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+    struct sched_param sp;
+    memset(&sp, 0, sizeof(sp));
+    sp.sched_priority = w->pool->rt_priority;
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+}
+
+static void *worker_main(void *arg) {
+    struct nsaw_worker *w = (struct nsaw_worker*)arg;
+    struct nsaw_worker_pool *pool = w->pool;
+
+    setup_worker_thread(w);
+
+    for (;;) {
+        while (sem_wait(&w->wake) != 0) {}  /* retry on EINTR */
+        if (__atomic_load_n(&pool->quit, __ATOMIC_ACQUIRE)) break;
+        run_jobs(pool);
+    }
+    return NULL;
+}
+
+int nsaw_worker_pool_default_threads(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = (int)cpus - 1;
+    if (threads > NSAW_MAX_WORKERS) threads = NSAW_MAX_WORKERS;
+    return threads > 0 ? threads : 0;
+}
+
+nsaw_worker_pool_t *nsaw_worker_pool_create(int threads) {
+    if (threads <= 0) return NULL;
+    if (threads > NSAW_MAX_WORKERS) threads = NSAW_MAX_WORKERS;
+
+    struct nsaw_worker_pool *pool =
+        (struct nsaw_worker_pool*)calloc(1, sizeof(struct nsaw_worker_pool));
+    if (!pool) return NULL;
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) cpus = 1;
+
+    /* Match the caller's RT priority if it has one */
+    int policy;
+    struct sched_param sp;
+    pool->rt_priority = NSAW_WORKER_RT_PRIORITY;
+    if (pthread_getschedparam(pthread_self(), &policy, &sp) == 0 &&
+        (policy == SCHED_FIFO || policy == SCHED_RR)) {
+        pool->rt_priority = sp.sched_priority;
+    }
+
+    for (int i = 0; i < threads; i++) {
+        struct nsaw_worker *w = &pool->workers[i];
+        w->pool = pool;
+        w->cpu = (int)((i + 1) % cpus);  /* leave core 0 to the caller */
+        if (sem_init(&w->wake, 0, 0) != 0) break;
+        if (pthread_create(&w->thread, NULL, worker_main, w) != 0) {
+            sem_destroy(&w->wake);
+            break;
+        }
+        pool->num_workers++;
+    }
+
+    if (pool->num_workers == 0) {
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void nsaw_worker_pool_destroy(nsaw_worker_pool_t *pool) {
+    if (!pool) return;
+    __atomic_store_n(&pool->quit, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < pool->num_workers; i++) {
+        sem_post(&pool->workers[i].wake);
+    }
+    for (int i = 0; i < pool->num_workers; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+        sem_destroy(&pool->workers[i].wake);
+    }
+    free(pool);
+}
+
+int nsaw_worker_pool_threads(const nsaw_worker_pool_t *pool) {
+    return pool ? pool->num_workers : 0;
+}
+
+void nsaw_worker_pool_run(nsaw_worker_pool_t *pool, nsaw_job_fn fn, void *ctx, int num_jobs) {
+    if (num_jobs <= 0) return;
+
+    /* Wake only as many workers as there are jobs beyond the caller's */
+    int wake = num_jobs - 1;
+    if (!pool) wake = 0;
+    else if (wake > pool->num_workers) wake = pool->num_workers;
+
+    if (wake == 0) {
+        for (int j = 0; j < num_jobs; j++) fn(ctx, j);
+        return;
+    }
+
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->generation++;
+    __atomic_store_n(&pool->jobs_done, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&pool->claim,
+                     (uint64_t)pool->generation << 32 | (uint64_t)num_jobs << 16,
+                     __ATOMIC_RELEASE);
+
+    for (int i = 0; i < wake; i++) {
+        sem_post(&pool->workers[i].wake);
+    }
+
+    run_jobs(pool);
+
+    /* Every job is claimed; wait for the ones running on workers. Spin
+     * briefly (jobs are sub-millisecond), then yield so a worker sharing
+     * this core can finish */
+    int spins = 0;
+    while (__atomic_load_n(&pool->jobs_done, __ATOMIC_ACQUIRE) < num_jobs) {
+        if (++spins < NSAW_WORKER_SPIN_LIMIT) cpu_relax();
+        else sched_yield();
+    }
+}
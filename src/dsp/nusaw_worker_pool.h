@@ -0,0 +1,48 @@
+/*
+ * nusaw_worker_pool.h - Real-time worker threads for parallel voice rendering
+ *
+ * A small fixed pool of worker threads (pinned one per core, SCHED_FIFO
+ * when permitted) that execute a batch of numbered jobs together with the
+ * calling thread. Jobs are claimed from a shared atomic counter, so idle
+ * threads take whatever work is left; there are no locks on the render
+ * path. The caller always participates and waits only for jobs a worker
+ * has already claimed, so a batch completes even if the workers are
+ * descheduled.
+ *
+ * Create/destroy are not real-time safe; nsaw_worker_pool_run is.
+ */
+
+#ifndef NUSAW_WORKER_POOL_H
+#define NUSAW_WORKER_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NSAW_MAX_WORKERS 3          /* Worker threads (plus the caller) */
+#define NSAW_WORKER_RT_PRIORITY 70  /* SCHED_FIFO priority if the caller is not RT */
+
+typedef struct nsaw_worker_pool nsaw_worker_pool_t;
+
+/* Job callback: run job `job` (0..num_jobs-1) of the current batch */
+typedef void (*nsaw_job_fn)(void *ctx, int job);
+
+/* Suggested worker count: one per spare core, up to NSAW_MAX_WORKERS */
+int nsaw_worker_pool_default_threads(void);
+
+/* Create a pool with `threads` workers (NULL if threads <= 0 or on error) */
+nsaw_worker_pool_t *nsaw_worker_pool_create(int threads);
+
+void nsaw_worker_pool_destroy(nsaw_worker_pool_t *pool);
+
+int nsaw_worker_pool_threads(const nsaw_worker_pool_t *pool);
+
+/* Run jobs 0..num_jobs-1 (num_jobs < 65536) across the workers and the
+ * calling thread; returns when every job has finished */
+void nsaw_worker_pool_run(nsaw_worker_pool_t *pool, nsaw_job_fn fn, void *ctx, int num_jobs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NUSAW_WORKER_POOL_H */
@@ -8,6 +8,10 @@
  *   1. Define your params: static const param_def_t my_params[] = { ... };
  *   2. In get_param: return param_helper_get(my_params, COUNT, values, key, buf, len);
  *   3. In set_param: return param_helper_set(my_params, COUNT, values, key, val);
+ *
+ * Parameters may declare a smoothing time (smooth_ms). The render loop then
+ * keeps one param_smoother_t per value and calls param_helper_smooth_step()
+ * once per control block to get zipper-free effective values.
  */
 
 #ifndef PARAM_HELPER_H
@@ -16,6 +20,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 
 /* Parameter types */
 typedef enum {
@@ -31,8 +36,15 @@ typedef struct {
     int index;            /* Index into values array */
     float min_val;        /* Minimum value */
     float max_val;        /* Maximum value */
+    float smooth_ms;      /* Smoothing time constant in ms (0 = none) */
 } param_def_t;
 
+/* One-pole smoother state, stepped once per control block */
+typedef struct {
+    float value;          /* Current smoothed value */
+    float coeff;          /* Per-step coefficient (0 = pass through) */
+} param_smoother_t;
+
 /*
  * Get a parameter value by key.
  * Returns: length written to buf, or -1 if key not found
@@ -111,6 +123,64 @@ static inline int param_helper_chain_params_json(
     return offset;
 }
 
+/*
+ * Set smoother coefficients for a control rate of step_rate_hz steps per
+ * second (sample_rate / control block size). Smoothed values are kept.
+ */
+static inline void param_helper_smooth_set_rate(
+    const param_def_t *defs,
+    int def_count,
+    param_smoother_t *smoothers,
+    float step_rate_hz
+) {
+    for (int i = 0; i < def_count; i++) {
+        param_smoother_t *s = &smoothers[defs[i].index];
+        if (defs[i].type == PARAM_TYPE_FLOAT && defs[i].smooth_ms > 0.0f) {
+            s->coeff = 1.0f - expf(-1000.0f / (defs[i].smooth_ms * step_rate_hz));
+        } else {
+            s->coeff = 0.0f;
+        }
+    }
+}
+
+/*
+ * Snap all smoothers to the current values (no glide).
+ */
+static inline void param_helper_smooth_reset(
+    const param_def_t *defs,
+    int def_count,
+    const float *values,
+    param_smoother_t *smoothers
+) {
+    for (int i = 0; i < def_count; i++) {
+        smoothers[defs[i].index].value = values[defs[i].index];
+    }
+}
+
+/*
+ * Advance all smoothers by one control step toward values[] and write the
+ * effective values to out[] (indexed like values[]). Parameters without a
+ * smoothing time pass straight through.
+ */
+static inline void param_helper_smooth_step(
+    const param_def_t *defs,
+    int def_count,
+    const float *values,
+    param_smoother_t *smoothers,
+    float *out
+) {
+    for (int i = 0; i < def_count; i++) {
+        int idx = defs[i].index;
+        param_smoother_t *s = &smoothers[idx];
+        if (s->coeff > 0.0f) {
+            s->value += (values[idx] - s->value) * s->coeff;
+        } else {
+            s->value = values[idx];
+        }
+        out[idx] = s->value;
+    }
+}
+
 /* Convenience macro for array count */
 #define PARAM_DEF_COUNT(arr) (sizeof(arr) / sizeof((arr)[0]))
 
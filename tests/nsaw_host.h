@@ -0,0 +1,86 @@
+/*
+ * nsaw_host.h - Minimal Move host for the NuSaw test programs
+ *
+ * Loads a built dsp.so the way the host does (dlopen, then
+ * move_plugin_init_v2) and looks up the NuSaw extensions. The ABI structs
+ * mirror the ones at the top of src/dsp/nusaw_plugin.cpp.
+ */
+
+#ifndef NSAW_HOST_H
+#define NSAW_HOST_H
+
+#include <dlfcn.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct host_api_v1 {
+    uint32_t api_version;
+    int sample_rate;
+    int frames_per_block;
+    uint8_t *mapped_memory;
+    int audio_out_offset;
+    int audio_in_offset;
+    void (*log)(const char *msg);
+    int (*midi_send_internal)(const uint8_t *msg, int len);
+    int (*midi_send_external)(const uint8_t *msg, int len);
+} host_api_v1_t;
+
+typedef struct plugin_api_v2 {
+    uint32_t api_version;
+    void* (*create_instance)(const char *module_dir, const char *json_defaults);
+    void (*destroy_instance)(void *instance);
+    void (*on_midi)(void *instance, const uint8_t *msg, int len, int source);
+    void (*set_param)(void *instance, const char *key, const char *val);
+    int (*get_param)(void *instance, const char *key, char *buf, int buf_len);
+    int (*get_error)(void *instance, char *buf, int buf_len);
+    void (*render_block)(void *instance, int16_t *out_interleaved_lr, int frames);
+} plugin_api_v2_t;
+
+typedef plugin_api_v2_t* (*move_plugin_init_v2_fn)(const host_api_v1_t *host);
+typedef void (*nsaw_render_float_fn)(void *instance, float *out_left, float *out_right,
+                                     int frames);
+typedef void (*nsaw_on_midi_timed_fn)(void *instance, const uint8_t *msg, int len,
+                                      int source, int frame);
+
+typedef struct {
+    host_api_v1_t host;
+    plugin_api_v2_t *api;
+    nsaw_render_float_fn render_float;
+    nsaw_on_midi_timed_fn on_midi_timed;
+} nsaw_host_t;
+
+static void nsaw_host_log(const char *msg) {
+    (void)msg;
+}
+
+/* Load dsp.so at `path` for a host running at sample_rate; 0 on success.
+ * The extensions are NULL in builds that predate them (benchmarks load
+ * older builds for comparison). */
+static inline int nsaw_host_load(nsaw_host_t *h, const char *path, int sample_rate) {
+    void *lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!lib) {
+        fprintf(stderr, "%s\n", dlerror());
+        return -1;
+    }
+    move_plugin_init_v2_fn init = (move_plugin_init_v2_fn)dlsym(lib, "move_plugin_init_v2");
+    h->render_float = (nsaw_render_float_fn)dlsym(lib, "nsaw_render_float");
+    h->on_midi_timed = (nsaw_on_midi_timed_fn)dlsym(lib, "nsaw_on_midi_timed");
+    if (!init) {
+        fprintf(stderr, "%s: missing plugin symbols\n", path);
+        return -1;
+    }
+
+    h->host.api_version = 1;
+    h->host.sample_rate = sample_rate;
+    h->host.frames_per_block = 128;
+    h->host.mapped_memory = NULL;
+    h->host.audio_out_offset = 0;
+    h->host.audio_in_offset = 0;
+    h->host.log = nsaw_host_log;
+    h->host.midi_send_internal = NULL;
+    h->host.midi_send_external = NULL;
+    h->api = init(&h->host);
+    return h->api ? 0 : -1;
+}
+
+#endif /* NSAW_HOST_H */